@@ -0,0 +1,144 @@
+/* Adalight streaming
+    A PC can take over the strip by pushing whole frames over Serial in the
+    framing Adalight senders (Prismatik, Hyperion, Boblight, ...) use:
+
+        'A' 'd' 'a'  count-1 (hi, lo)  hi ^ lo ^ 0x55  then count r, g, b triplets
+
+    The pixel bytes are read straight into leds[] (CRGB is r, g, b in three
+    bytes) and shown through the power limiter, there is no second buffer.
+    Pixels past NUM_LEDS are read and dropped, LEDs past the frame go dark.
+
+    The Pro Mini only buffers 64 received bytes and loses whatever arrives
+    while the strip is clocked out with interrupts off, so a sender firing
+    frames blindly drops some.  Once a frame is shown the next checkSerial()
+    writes ADALIGHT_ACK and waits up to ADALIGHT_WAIT ms for the next header,
+    so a sender that waits for that byte always lands its frame inside
+    readBytes() instead of behind a busy loop.  A dropped frame is answered
+    with ADALIGHT_NAK instead, so a waiting sender carries on either way.
+    Standard Adalight senders never read either byte.
+
+    Pixel bytes would read as commands, so once an 'A' has been taken the
+    other serial commands are ignored:  a dropped frame's remains are skipped
+    up to the next header, until one parses or the line has been quiet for
+    ADALIGHT_TIMEOUT ms.  While frames keep arriving the schedule is paused,
+    ADALIGHT_TIMEOUT ms after the last frame the strip fades back to it.
+    tools/adalight_bench.py measures frames/s and drops.
+*/
+#define ADALIGHT_ACK 0x06          // Frame shown, ready for the next (ASCII ACK)
+#define ADALIGHT_NAK 0x15          // Frame dropped, ready for the next (ASCII NAK)
+#define ADALIGHT_WAIT 20           // Milliseconds to wait for a frame after the ACK
+#define ADALIGHT_BYTE_TIMEOUT 10   // Gap in a frame that drops it (ms)
+#define ADALIGHT_TIMEOUT 1000      // Milliseconds without a frame before the schedule takes over
+#define ADALIGHT_BRIGHTNESS 255    // Senders send final colors, only the power limiter dims them
+
+bool adalight_streaming = false;    // a sender owns the strip
+bool adalight_syncing = false;      // skipping a dropped frame, commands ignored
+byte adalight_reply = 0;            // ACK or NAK not sent yet, 0 if none
+unsigned long adalight_last = 0;    // millis() of the last frame shown
+unsigned long adalight_rx = 0;      // millis() bytes were last seen while syncing
+unsigned long adalight_frames = 0;  // frames shown
+unsigned long adalight_dropped = 0; // bad headers and frames cut short
+
+// Frame garbled or cut short:  tell the sender, skip what is left of it
+void adalightDrop()
+{
+    adalight_dropped++;
+    adalight_reply = ADALIGHT_NAK;
+    adalight_syncing = true;
+    adalight_rx = millis();
+}
+
+// Read one frame, the leading 'A' already taken
+void adalightFrame()
+{
+    byte header[5];
+
+    Serial.setTimeout(ADALIGHT_BYTE_TIMEOUT);
+    if ((Serial.readBytes((char *)header, sizeof(header)) != sizeof(header)) ||
+        (header[0] != 'd') || (header[1] != 'a') || (header[4] != (header[2] ^ header[3] ^ 0x55)))
+    {
+        adalightDrop();
+        return;
+    }
+
+    uint16_t count = ((header[2] << 8) | header[3]) + 1;
+    uint16_t shown = min(count, (uint16_t)NUM_LEDS);
+    size_t bytes = shown * sizeof(CRGB);
+    if (Serial.readBytes((char *)leds, bytes) != bytes)
+    {
+        adalightDrop();
+        return;
+    }
+
+    // Pixels the strip does not have
+    for (uint32_t extra = (uint32_t)(count - shown) * sizeof(CRGB); extra > 0; extra--)
+    {
+        char skip;
+        if (Serial.readBytes(&skip, 1) != 1)
+        {
+            adalightDrop();
+            return;
+        }
+    }
+    fill_solid(leds + shown, NUM_LEDS - shown, CRGB::Black);
+
+    if (!adalight_streaming)
+    {
+        adalight_streaming = true;
+        logEvent(EVT_STREAM, 1);
+    }
+
+    byte brightness = powerLimit(leds, NUM_LEDS, ADALIGHT_BRIGHTNESS);
+    ledsShow(brightness);
+
+    // Where the fade back to the schedule starts from
+    led_shown.color = leds[NUM_LEDS / 2];
+    led_shown.brightness = brightness;
+
+    adalight_last = millis();
+    adalight_frames++;
+    adalight_reply = ADALIGHT_ACK;
+    adalight_syncing = false;
+}
+
+// True while a sender owns the strip, hands it back to the schedule once the frames stop
+bool adalightActive()
+{
+    if (adalight_streaming && ((millis() - adalight_last) >= ADALIGHT_TIMEOUT))
+    {
+        adalight_streaming = false;
+        adalight_reply = 0;
+        logEvent(EVT_STREAM, 0);
+        timelineFade(LED_FADE_OFF);
+    }
+
+    return adalight_streaming;
+}
+
+// Serial input while streaming or syncing:  answer the last frame and take the next one
+void adalightPoll()
+{
+    Serial.setTimeout(0);
+    if (adalight_reply != 0)
+    {
+        Serial.write(adalight_reply);
+        adalight_reply = 0;
+        Serial.setTimeout(ADALIGHT_WAIT);
+    }
+
+    if (Serial.available())
+    {
+        adalight_rx = millis();
+    }
+    else if (adalight_syncing && ((millis() - adalight_rx) >= ADALIGHT_TIMEOUT))
+    {
+        adalight_syncing = false; // the line went quiet, back to commands
+        return;
+    }
+
+    // Anything before the header is left over from a dropped frame
+    if (Serial.find((char *)"A"))
+    {
+        adalightFrame();
+    }
+}
@@ -9,17 +9,9 @@
 */
 
 /* Hardware Libraries
+    Pulled in by the board's backend, see hal.h
  */
-//#include <Adafruit_GFX.h>    // LCD - Core graphics library
-//#include <Adafruit_ST7735.h> // LCD - Hardware-specific library
-#include <EEPROM.h> // Arduino's harddrive
-#include "RTClib.h" // RTC
-#include <SPI.h>    // LCD
-#include <TFT.h>    // LCD
-#include <Wire.h>   // RTC & LEDs
-
-#define FASTLED_ALLOW_INTERRUPTS 0
-#include <FastLED.h> // LEDs
+#include "./hal.h"
 
 /* RTC
     DS1307 Real Time Clock Breakout Board - connected via I2C and Wire.h
@@ -32,15 +24,37 @@ RTC_DS1307 rtc;
     https://www.amazon.com/gp/product/B00ZHB9M6A/ref=oh_aui_search_detailpage?ie=UTF8&psc=1
 */
 #define NUM_LEDS 150
-#define DATA_PIN 6 // Digital (LED data pin)
+#define LED_SEGMENTS 1          // Data pins the strip is split across (1 - 4), see led_segments.h
+#define LED_SEGMENT_REVERSED 0  // Bit per segment wired from its last LED
+#ifndef HAL_PINS
+#define DATA_PIN 6   // Digital (LED data pin, segment 1)
+#define DATA_PIN_2 5 // Digital (segment 2)
+#define DATA_PIN_3 14 // A0 (segment 3)
+#define DATA_PIN_4 15 // A1 (segment 4)
+#endif
 
 CRGB leds[NUM_LEDS];
 
+#define LED_FADE_IN 3000     // Sunrise starting (ms)
+#define LED_FADE_END 10000   // Sunrise finished (ms)
+#define LED_FADE_OFF 1500    // Snooze or LEDs turned off (ms)
+#define LED_FADE_SETUP 1000  // Entering or leaving setup mode (ms)
+#define LED_SETUP_PULSE 2000 // One setup mode flash cycle (ms)
+
+/* Serial console
+    Commands, telemetry and Adalight frames share the port.  500000 baud is
+    exact on the Pro Mini's 16MHz clock (115200 is 2% off) and moves an
+    Adalight frame four times faster.
+*/
+#define SERIAL_BAUD 500000
+
 /* Buttons
 */
+#ifndef HAL_PINS
 #define BTN_OK 2         // Digital (button_ok)
 #define BTN_LEFT 7       // Digital (button_left)
 #define BTN_RIGHT 3      // Digital (button_right)
+#endif
 #define LONG_BTN_PRESS 2 // Long press (in seconds)
 
 /* TFT Screen
@@ -48,10 +62,16 @@ CRGB leds[NUM_LEDS];
     http://www.adafruit.com/products/358
 */
 #define BACKGROUND CRGB(0, 0, 0)
+#ifndef HAL_PINS
 #define TFT_DC 8  // Digital
 #define TFT_RST 9 // Digital
 #define TFT_CS 10 // Digital
 #define SD_CS 4   // Digital
+#endif
+
+#define IDLE_TIMEOUT 5 // Minutes without a button press before the screen idles
+#define ST7735_IDMOFF 0x38 // Idle mode off (full color)
+#define ST7735_IDMON 0x39  // Idle mode on (8 colors, reduced power)
 // #define TFT_MOSI    11
 /* TFT_SCLK is specified for faster LCD functionality
      https://learn.adafruit.com/1-8-tft-display/breakout-wiring-and-test
@@ -59,7 +79,13 @@ CRGB leds[NUM_LEDS];
 // #define TFT_SCLK    13
 //Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_MOSI, TFT_SCLK, TFT_RST);
 //Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS,  TFT_DC, TFT_RST);
+// #define TFT_PROFILE // Count SPI traffic per drawing function (serial command 'P')
+#include "./tft_profile.h"
+#ifdef TFT_PROFILE
+MeteredTFT tft = MeteredTFT(TFT_CS, TFT_DC, TFT_RST);
+#else
 TFT tft = TFT(TFT_CS, TFT_DC, TFT_RST);
+#endif
 
 struct RGB
 {
@@ -77,10 +103,15 @@ struct RGB punctuation_color = {255, 255, 255};
 /* Variables
 */
 bool setup_mode = false;
-bool sleep_mode = false;
+bool sleep_mode = false; // Sunrise snoozed until snooze_until
 bool sunrise_mode = false;
+uint32_t snooze_until = 0; // RTC (standard) unixtime the snooze ends, 0 if none
 
-byte sleep_timer = 15; // How long to disable sunrise (minutes)
+bool display_idle = false; // Screen showing only the idle clock
+bool lcd_repaint = true;   // Redraw every element on the next updateLcd()
+unsigned long last_activity = 0; // millis() of the last button press
+
+byte sleep_timer = 15; // How long a snooze holds the sunrise off (minutes)
 byte alarm_time = 60;  // How long sunrise lasts (minutes)
 
 // TODO:  check if this can be reduced to [7] instead of [7][12]
@@ -88,20 +119,45 @@ char daysOfTheWeek[7][12] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursd
 DateTime now_last;
 DateTime now_now;
 
-/*
-   Notes:
-    following DATE(1) format to 'd'
-    Sunrise = DATE+1
+/* Minute of the week
+    The alarm logic works on one integer clock: minutes since Sunday 00:00.
+    now_mow is stepped once per minute instead of being rebuilt from the
+    DateTime, and alarm_mow caches each day's sunrise start so checking the
+    window needs no EEPROM reads or DateTime math.
 */
-#define SETTINGS 11
-char setting_entries_dict[SETTINGS] = {
-    'H', 'M', 'S', 'p', 'Y', 'm', 'd', 'u', // Current DateTime
-    'I', 'N', 'q',                          // Next Sunrise
-};
-byte setting_entry = 0; // setup mode pointer
+#define MINUTES_PER_DAY 1440
+#define MINUTES_PER_WEEK 10080
+uint16_t now_mow = 0;   // current minute of the week
+byte now_dow = 0;       // current day of the week (0 = Sunday)
+byte mow_minute = 0;    // now_now.minute() when now_mow was last updated
+uint16_t alarm_mow[7];  // sunrise start per DoW (minute of the week)
+int sunrise_minutes = -1; // minutes into the current sunrise, -1 outside one
+uint16_t mode_mow = 0xFFFF; // now_mow the sunrise window was last checked for
+byte sunrise_dow = 0;     // DoW of the alarm that started the current sunrise
+
+byte setting_entry = 0; // setup mode pointer (row of settings[])
 byte alarm_setup = 0;   // setup mode pointer for DoW alarm
 byte tmp_byte = 0;      // declared globally to prevent repetitive instantiations
 
+/* EEPROM layout
+    0 - 6       Sunrise hour (per DoW)
+    7 - 13      Sunrise minute (per DoW)
+    14          Solar mode (1 = on)
+    15          Solar offset (signed minutes)
+    16 - 19     Checkpoint (snooze deadline)
+    20 - 21     Unused
+    22          Sunrise length (minutes)
+    23          Snooze length (minutes)
+    512 - 1023  Event log ring
+*/
+#define EEPROM_SOLAR_MODE 14
+#define EEPROM_SOLAR_OFFSET 15
+#define EEPROM_CHECKPOINT 16
+#define EEPROM_ALARM_TIME 22
+#define EEPROM_SLEEP_TIMER 23
+#define EEPROM_EVENT_LOG 512
+#define EVENT_LOG_BYTES 512
+
 /* Program functions
 */
 
@@ -110,7 +166,7 @@ byte tmp_byte = 0;      // declared globally to prevent repetitive instantiation
 // Read the byte stored at the target EEPROM address
 byte readEByte(byte target)
 {
-    byte value = EEPROM.read(target);
+    byte value = halEepromRead(target);
 
     return value;
 }
@@ -118,7 +174,7 @@ byte readEByte(byte target)
 // Write the value byte to the target EEPROM address
 void writeEByte(byte target, byte value)
 {
-    EEPROM.write(target, value);
+    halEepromWrite(target, value);
 }
 
 // Read the target EEPROM address for sunrise hour
@@ -165,117 +221,307 @@ void setSunriseMin(byte target, byte value)
 {
     if (target > 6)
     {
-        return 0;
+        return;
     }
 
     target += 7;
-    EEPROM.write(target, value);
+    writeEByte(target, value);
 }
 
-// Check current time against today's alarm
-void checkModeActive()
+#include "./event_log.h"
+#include "./power.h"
+#include "./led_segments.h"
+#include "./timeline.h"
+#include "./solar.h"
+#include "./tz.h"
+#include "./adalight.h"
+
+/* Minute of the week functions
+*/
+// Reload the cached sunrise start of every day, needed after alarm edits
+//   In solar mode the next six days and yesterday use that date's real sunrise
+void refreshAlarms()
 {
-    tmp_byte = now_now.dayOfTheWeek();
+    bool solar = solarEnabled();
 
-    DateTime alarm_dtm = DateTime(
-        now_now.year(),
-        now_now.month(),
-        now_now.day(),
-        getSunriseHour(tmp_byte),
-        getSunriseMin(tmp_byte),
-        0);
+    for (byte i = 0; i < 7; i++)
+    {
+        int start = getSunriseHour(i) * 60 + getSunriseMin(i);
 
-    int delta = now_now.unixtime() - alarm_dtm.unixtime();
+        if (solar)
+        {
+            int days = (i + 7 - now_dow) % 7;
+            if (days == 6)
+            {
+                days = -1;
+            }
 
-    if (delta < 0)
+            DateTime date = DateTime(now_now.unixtime() + days * 86400L);
+            int sunrise = solarSunrise(date);
+            if (sunrise >= 0)
+            {
+                // The table is in standard time, alarms are on the wall clock
+                start = sunrise + tzDstMinutes(date, sunrise) + solarOffset();
+                if (start < 0)
+                {
+                    start += MINUTES_PER_DAY;
+                }
+                else if (start >= MINUTES_PER_DAY)
+                {
+                    start -= MINUTES_PER_DAY;
+                }
+            }
+        }
+
+        alarm_mow[i] = i * MINUTES_PER_DAY + start;
+    }
+}
+
+// Rebuild now_mow from the RTC time, needed at boot and after clock edits
+void syncMinuteOfWeek()
+{
+    now_dow = now_now.dayOfTheWeek();
+    now_mow = now_dow * MINUTES_PER_DAY + now_now.hour() * 60 + now_now.minute();
+    mow_minute = now_now.minute();
+    mode_mow = 0xFFFF; // the alarms may have moved too
+}
+
+// Step now_mow when the RTC moves on to the next minute
+void tickMinuteOfWeek()
+{
+    if (now_now.minute() == mow_minute)
     {
-        // The sun has not yet risen
-        sleep_mode = false;
-        sunrise_mode = false;
+        return;
     }
-    else if (delta <= (alarm_time * 60))
+
+    // Anything other than a single minute step means the clock was moved
+    if (now_now.minute() != ((mow_minute + 1) % 60))
     {
-        // The sun is rising
-        sunrise_mode = (!sleep_mode);
+        syncMinuteOfWeek();
+        return;
     }
-    else
+
+    mow_minute = now_now.minute();
+    now_mow++;
+    if (now_mow == MINUTES_PER_WEEK)
     {
-        // The sun will rise again
-        sunrise_mode = false;
-        sleep_mode = false;
+        now_mow = 0;
+    }
+    if ((now_now.hour() == 0) && (mow_minute == 0))
+    {
+        now_dow = now_mow / MINUTES_PER_DAY;
+
+        // Solar sunrises follow the calendar date, and DST shifts only last a day
+        refreshAlarms();
     }
 }
 
-/* LED functions
-*/
-void ledsColor(CRGB color)
+// Minutes since the start of the sunrise covering now_mow, or -1 if there is none
+//   Yesterday's sunrise is checked too, since a late one can run past midnight
+int sunriseElapsed()
 {
-    for (int i = 0; i < NUM_LEDS; i++)
+    tmp_byte = now_dow;
+    for (byte i = 0; i < 2; i++)
     {
-        leds[i] = color;
+        int elapsed = (int)now_mow - (int)alarm_mow[tmp_byte];
+        if (elapsed < 0)
+        {
+            elapsed += MINUTES_PER_WEEK;
+        }
+
+        if (elapsed <= alarm_time)
+        {
+            return elapsed;
+        }
+
+        tmp_byte = (tmp_byte == 0) ? 6 : tmp_byte - 1;
     }
 
-    FastLED.show();
+    return -1;
 }
 
-// Cycle through all LEDs and set to Black
-void turnLedsOff()
+/* Checkpoint functions
+    Keeps enough state in EEPROM for a sunrise to survive a power blip:  the
+    snooze deadline.  The sunrise window and its brightness follow from the
+    clock and the alarms, so the checkpoint is only written when the mode
+    changes or a snooze starts, not on every brightness step.
+*/
+struct __attribute__((packed)) Checkpoint // 4 bytes on every board
+{
+    uint32_t snooze_until; // snooze deadline (RTC unixtime), 0 if none
+};
+
+static_assert(EEPROM_CHECKPOINT + sizeof(Checkpoint) <= EEPROM_ALARM_TIME, "checkpoint runs into the settings");
+
+Checkpoint checkpoint;
+
+void saveCheckpoint()
 {
-    ledsColor(CRGB::Black);
+    checkpoint.snooze_until = snooze_until;
+
+    halEepromPut(EEPROM_CHECKPOINT, checkpoint);
 }
 
-// Update LEDs for sunrise, brightness varies by time since alarm started
-void sunrise()
+// Pick the sunrise state back up after a reset, needs now_std
+void restoreCheckpoint()
 {
-    // Only run this function during sunrise mode (disabled in setup mode)
-    if (!sunrise_mode || setup_mode || sleep_mode)
+    halEepromGet(EEPROM_CHECKPOINT, checkpoint);
+
+    // A snooze carries over until its deadline.  One further off than a
+    // snooze can last is stale, e.g. the RTC fell back to the compile time
+    uint32_t now_time = now_std.unixtime();
+    if ((checkpoint.snooze_until > now_time) && ((checkpoint.snooze_until - now_time) <= sleep_timer * 60UL))
     {
-        turnLedsOff();
-        return;
+        snooze_until = checkpoint.snooze_until;
+        sleep_mode = true;
     }
 
-    tmp_byte = now_now.dayOfTheWeek();
-    int sr_minutes = getSunriseHour(tmp_byte) * 60 + getSunriseMin(tmp_byte);
-    int cur_minutes = now_now.hour() * 60 + now_now.minute();
+    // Mirror what is in force so checkModeActive() does not rewrite a stale
+    // deadline before the first frame, setup() clears it afterwards
+    checkpoint.snooze_until = snooze_until;
+}
+
+// Hold the sunrise off for sleep_timer minutes, pressing again starts the wait over
+void snooze()
+{
+    snooze_until = now_std.unixtime() + sleep_timer * 60UL;
+    sleep_mode = true;
+    sunrise_mode = false;
+}
+
+// Check current time against today's alarm
+//   Per loop this is the snooze deadline and a minute compare; the window is
+//   only looked up again when the minute of the week moves
+void checkModeActive()
+{
+    bool was_rising = sunrise_mode;
 
-    // Sunrise has ended.
-    if (cur_minutes > (sr_minutes + alarm_time))
+    if (sleep_mode && (now_std.unixtime() >= snooze_until))
     {
-        sunrise_mode = false;
+        // Snooze over, the ramp picks up where the elapsed time puts it
         sleep_mode = false;
-        turnLedsOff();
+        snooze_until = 0;
+        logEvent(EVT_SNOOZE_END, sunrise_minutes >= 0);
+    }
+
+    if (now_mow != mode_mow)
+    {
+        mode_mow = now_mow;
+        sunrise_minutes = sunriseElapsed();
+
+        // The sun is rising, sunriseElapsed() left the alarm's DoW in tmp_byte
+        if (sunrise_minutes >= 0)
+        {
+            sunrise_dow = tmp_byte;
+        }
+    }
+
+    sunrise_mode = (sunrise_minutes >= 0) && !sleep_mode;
+
+    if (sunrise_mode != was_rising)
+    {
+        logEvent(sunrise_mode ? EVT_SUNRISE_START : EVT_SUNRISE_END, sunrise_dow);
+        timelineFade(sunrise_mode ? LED_FADE_IN : LED_FADE_END);
+    }
+
+    if ((sunrise_mode != was_rising) || (snooze_until != checkpoint.snooze_until))
+    {
+        saveCheckpoint();
+    }
+}
+
+/* LED functions
+*/
+// Fade out from whatever is showing, the mode decides what the strip settles on
+void turnLedsOff()
+{
+    timelineFade(LED_FADE_OFF);
+}
+
+// Target frame for sunrise, brightness varies by time since alarm started
+void sunrise()
+{
+    // Only run this function during sunrise mode (disabled in setup mode)
+    if (!sunrise_mode || setup_mode || sleep_mode)
+    {
+        led_target.color = CRGB::Black;
         return;
     }
 
     // calculate the current brightness - should start off dim and get brighter towards the end
-    int cur_brightness = cur_minutes - sr_minutes;
-    FastLED.setBrightness(map(cur_brightness, 0, alarm_time, 5, 255));
-    fill_solid(leds, NUM_LEDS, CRGB(255, 150, 25));
-
-    FastLED.show();
+    led_target.brightness = map(sunrise_minutes, 0, alarm_time, 5, 255);
+    led_target.color = CRGB(255, 150, 25);
 }
 
 // Update the states of the LED strand
 void updateLed()
 {
-    if (setup_mode)
+    if (adalightActive())
     {
-        FastLED.setBrightness(25);
+        return; // A sender owns the strip
+    }
 
+    if (setup_mode)
+    {
         // Flash LEDS to indicate we're in setup mode
-        if (now_now.second() % 2 == 0)
+        if (!timelineRunning(TL_PULSE))
         {
-            ledsColor(CRGB::DarkSlateGray);
-        }
-        else
-        {
-            ledsColor(CRGB::LightGreen);
+            timelinePulse(CRGB::DarkSlateGray, CRGB::LightGreen, LED_SETUP_PULSE);
         }
+        led_target.brightness = 25;
     }
     else
     {
+        timelineStop(TL_PULSE);
         sunrise();
     }
+
+    showFrame(led_target);
+}
+
+/* Display functions
+*/
+// Send a bare command byte to the ST7735, for the commands the TFT library does not expose
+void tftCommand(byte command)
+{
+#ifdef TFT_PROFILE
+    tft_commands++;
+#endif
+    halTftCommand(TFT_CS, TFT_DC, command);
+}
+
+// Blank the screen and have updateLcd() redraw everything
+void clearLcd()
+{
+    tft.background(bg_color.r, bg_color.g, bg_color.b);
+    lcd_repaint = true;
+}
+
+// Drop to the idle clock once nobody has touched a button for IDLE_TIMEOUT minutes
+void checkIdle()
+{
+    if (display_idle || setup_mode || ((millis() - last_activity) < (IDLE_TIMEOUT * 60000UL)))
+    {
+        return;
+    }
+
+    display_idle = true;
+    clearLcd();
+    tftCommand(ST7735_IDMON);
+}
+
+// Leave the idle clock, the next updateLcd() repaints the full screen
+void wakeDisplay()
+{
+    last_activity = millis();
+    if (!display_idle)
+    {
+        return;
+    }
+
+    display_idle = false;
+    tftCommand(ST7735_IDMOFF);
+    clearLcd();
 }
 
 /* Button functions
@@ -285,18 +531,33 @@ byte buttonPress(byte button)
     unsigned long start_press = 0;
     byte ret_val = 0;
 
-    while (digitalRead(button) == LOW)
+    // Any press wakes an idle screen, and is not acted on otherwise.  The
+    // screen has always gone idle by the time the sun rises, so during a
+    // sunrise (or its snooze) the press counts and one OK snoozes
+    if ((halButtonDown(button)) && display_idle)
+    {
+        wakeDisplay();
+        if (sunrise_minutes < 0)
+        {
+            while (halButtonDown(button))
+                ;
+            return 0;
+        }
+    }
+
+    while (halButtonDown(button))
     {
         // initial loop run
         if (start_press == 0)
         {
             start_press = rtc.now().unixtime();
+            last_activity = millis();
         }
 
         // Long press
         if ((rtc.now().unixtime() - start_press) >= LONG_BTN_PRESS)
         {
-            tft.background(bg_color.r, bg_color.g, bg_color.b);
+            clearLcd();
             ret_val = 2;
         }
         // short press
@@ -309,177 +570,209 @@ byte buttonPress(byte button)
     return ret_val;
 }
 
-void increaseSettingsValue()
+/* Settings
+    One row per setup mode entry, in the order OK and a long left/right press
+    step through them.  A short left/right press hands the selected row to
+    adjustSetting(), so a new setting is a new row plus a spot on the screen
+    that draws its key.
+
+    Notes:
+     following DATE(1) format to 'd'
+     Sunrise = DATE+1
+*/
+// Where a setting is stored
+#define SET_CLOCK 0  // target = SET_CLOCK_* field of the wall clock
+#define SET_RAM 1    // target = SET_RAM_* index into setting_ram[]
+#define SET_EEPROM 2 // target = EEPROM address
+
+#define SET_CLOCK_YEAR 0 // years since 2000
+#define SET_CLOCK_MONTH 1
+#define SET_CLOCK_DAY 2
+#define SET_CLOCK_HOUR 3
+#define SET_CLOCK_MINUTE 4
+#define SET_CLOCK_SECOND 5
+
+#define SET_RAM_ALARM_DOW 0
+#define SET_RAM_ALARM_TIME 1
+#define SET_RAM_SLEEP_TIMER 2
+
+// Flags
+#define SET_WRAP 0x01       // stepping past either end wraps around, clamps otherwise
+#define SET_PER_DAY 0x02    // EEPROM address is offset by the selected alarm DoW
+#define SET_SIGNED 0x04     // EEPROM byte holds an int8_t
+#define SET_MONTH_DAYS 0x08 // upper bound is the length of the current month
+
+#define SET_NO_EEPROM 0xFF
+
+struct Setting
+{
+    char key;     // screen field and event log payload
+    byte store;   // SET_CLOCK, SET_RAM or SET_EEPROM
+    byte target;  // clock field, RAM index or EEPROM address
+    byte address; // EEPROM copy of a RAM setting, restored by loadSettings()
+    byte flags;
+    byte step;
+    int16_t low;
+    int16_t high;
+};
+
+byte *const setting_ram[] = {&alarm_setup, &alarm_time, &sleep_timer};
+
+const Setting settings[] PROGMEM = {
+    // Current DateTime
+    {'H', SET_CLOCK, SET_CLOCK_HOUR, SET_NO_EEPROM, SET_WRAP, 1, 0, 23},
+    {'M', SET_CLOCK, SET_CLOCK_MINUTE, SET_NO_EEPROM, SET_WRAP, 1, 0, 59},
+    {'S', SET_CLOCK, SET_CLOCK_SECOND, SET_NO_EEPROM, SET_WRAP, 1, 0, 59},
+    {'p', SET_CLOCK, SET_CLOCK_HOUR, SET_NO_EEPROM, SET_WRAP, 12, 0, 23},
+    {'Y', SET_CLOCK, SET_CLOCK_YEAR, SET_NO_EEPROM, 0, 1, 0, 99},
+    {'m', SET_CLOCK, SET_CLOCK_MONTH, SET_NO_EEPROM, SET_WRAP, 1, 1, 12},
+    {'d', SET_CLOCK, SET_CLOCK_DAY, SET_NO_EEPROM, SET_WRAP | SET_MONTH_DAYS, 1, 1, 31},
+    {'u', SET_RAM, SET_RAM_ALARM_DOW, SET_NO_EEPROM, SET_WRAP, 1, 0, 6},
+    // Next Sunrise
+    {'I', SET_EEPROM, 0, SET_NO_EEPROM, SET_WRAP | SET_PER_DAY, 1, 0, 23},
+    {'N', SET_EEPROM, 7, SET_NO_EEPROM, SET_WRAP | SET_PER_DAY, 1, 0, 59},
+    {'q', SET_EEPROM, 0, SET_NO_EEPROM, SET_WRAP | SET_PER_DAY, 12, 0, 23},
+    {'L', SET_RAM, SET_RAM_ALARM_TIME, EEPROM_ALARM_TIME, 0, 5, 10, 120},
+    {'z', SET_RAM, SET_RAM_SLEEP_TIMER, EEPROM_SLEEP_TIMER, 0, 5, 5, 60},
+    // Solar mode and offset
+    {'A', SET_EEPROM, EEPROM_SOLAR_MODE, SET_NO_EEPROM, SET_WRAP, 1, 0, 1},
+    {'O', SET_EEPROM, EEPROM_SOLAR_OFFSET, SET_NO_EEPROM, SET_SIGNED, SOLAR_OFFSET_STEP, -SOLAR_OFFSET_MAX, SOLAR_OFFSET_MAX},
+};
+#define SETTINGS (sizeof(settings) / sizeof(settings[0]))
+
+/* Settings functions
+*/
+// Key of a setup mode entry, as passed to tftDrawInfo()
+char settingKey(byte entry)
+{
+    return pgm_read_byte(&settings[entry].key);
+}
+
+// Restore the RAM settings saved in EEPROM, an erased or bad value keeps the default
+void loadSettings()
 {
-    bool pending_update = false;
+    Setting setting;
 
-    switch (setting_entries_dict[setting_entry])
+    for (byte i = 0; i < SETTINGS; i++)
     {
-    case 'Y': // Current year
-        rtc.adjust(DateTime(
-            now_now.year() + 1,
-            now_now.month(),
-            now_now.day(),
-            now_now.hour(),
-            now_now.minute(),
-            now_now.second()));
-        pending_update = true;
-        break;
-    case 'm': // Current month
-        rtc.adjust(DateTime(
-            now_now.year(),
-            now_now.month() + 1,
-            now_now.day(),
-            now_now.hour(),
-            now_now.minute(),
-            now_now.second()));
-        pending_update = true;
-        break;
-    case 'd': // Current day
-        rtc.adjust(DateTime(now_now.unixtime() + 86400));
-        pending_update = true;
-        break;
-    case 'u': // alarm DoW selection
-        alarm_setup++;
-        if (alarm_setup > 6)
+        memcpy_P(&setting, &settings[i], sizeof(Setting));
+        if ((setting.store != SET_RAM) || (setting.address == SET_NO_EEPROM))
         {
-            alarm_setup = 0;
+            continue;
+        }
+
+        tmp_byte = readEByte(setting.address);
+        if ((tmp_byte >= setting.low) && (tmp_byte <= setting.high))
+        {
+            *setting_ram[setting.target] = tmp_byte;
         }
-        pending_update = true;
-        break;
-    case 'H': // Current hour
-        rtc.adjust(DateTime(now_now.unixtime() + 3600));
-        pending_update = true;
-        break;
-    case 'M': // Current minute
-        rtc.adjust(DateTime(now_now.unixtime() + 60));
-        pending_update = true;
-        break;
-    case 'S': // Current seconds
-        rtc.adjust(DateTime(now_now.unixtime() + 2));
-        pending_update = true;
-        break;
-    case 'p': // Current AM/PM
-        rtc.adjust(DateTime(now_now.unixtime() + 43200));
-        pending_update = true;
-        break;
-    case 'I': // Sunrise hour
-        tmp_byte = getSunriseHour(alarm_setup);
-        tmp_byte++;
-        writeEByte(alarm_setup, tmp_byte % 24);
-        pending_update = true;
-        break;
-    case 'N': // Sunrise minute
-        tmp_byte = getSunriseMin(alarm_setup);
-        tmp_byte++;
-        setSunriseMin(alarm_setup, tmp_byte % 60);
-        pending_update = true;
-        break;
-    case 'q': // Sunrise am/pm
-        tmp_byte = getSunriseHour(alarm_setup);
-        tmp_byte = (tmp_byte + 12) % 24;
-        writeEByte(alarm_setup, tmp_byte);
-        pending_update = true;
-        break;
     }
+}
+
+// Wall clock in SET_CLOCK_* order
+void clockFields(int *fields)
+{
+    fields[SET_CLOCK_YEAR] = now_now.year() - 2000;
+    fields[SET_CLOCK_MONTH] = now_now.month();
+    fields[SET_CLOCK_DAY] = now_now.day();
+    fields[SET_CLOCK_HOUR] = now_now.hour();
+    fields[SET_CLOCK_MINUTE] = now_now.minute();
+    fields[SET_CLOCK_SECOND] = now_now.second();
+}
+
+int settingRead(const Setting &setting)
+{
+    int fields[6];
 
-    if (pending_update)
+    switch (setting.store)
     {
-        tft.background(bg_color.r, bg_color.g, bg_color.b);
-        now_now = rtc.now();
+    case SET_CLOCK:
+        clockFields(fields);
+        return fields[setting.target];
+    case SET_RAM:
+        return *setting_ram[setting.target];
+    default:
+        tmp_byte = readEByte(setting.target + ((setting.flags & SET_PER_DAY) ? alarm_setup : 0));
+        return (setting.flags & SET_SIGNED) ? (int8_t)tmp_byte : tmp_byte;
     }
 }
 
-void decreaseSettingsValue()
+void settingWrite(const Setting &setting, int value)
 {
-    bool pending_update = false;
+    int fields[6];
 
-    switch (setting_entries_dict[setting_entry])
+    switch (setting.store)
     {
-    case 'Y': // Current year
-        rtc.adjust(DateTime(
-            now_now.year() - 1,
-            now_now.month(),
-            now_now.day(),
-            now_now.hour(),
-            now_now.minute(),
-            now_now.second()));
-        pending_update = true;
-        break;
-    case 'm': // Current month
-        rtc.adjust(DateTime(
-            now_now.year(),
-            now_now.month() - 1,
-            now_now.day(),
-            now_now.hour(),
-            now_now.minute(),
-            now_now.second()));
-        pending_update = true;
-        break;
-    case 'd': // Current day
-        rtc.adjust(DateTime(now_now.unixtime() - 86400));
-        pending_update = true;
-        break;
-    case 'u': // alarm DoW selection
-        if (alarm_setup == 0)
-        {
-            alarm_setup = 6;
-        }
-        else
+    case SET_CLOCK:
+        clockFields(fields);
+        fields[setting.target] = value;
+
+        // Keep the day valid when the month or year changes under it
+        tmp_byte = tzDaysInMonth(2000 + fields[SET_CLOCK_YEAR], fields[SET_CLOCK_MONTH]);
+        if (fields[SET_CLOCK_DAY] > tmp_byte)
         {
-            alarm_setup--;
+            fields[SET_CLOCK_DAY] = tmp_byte;
         }
-        pending_update = true;
-        break;
-    case 'H': // Current hour
-        rtc.adjust(DateTime(now_now.unixtime() - 3600));
-        pending_update = true;
-        break;
-    case 'M': // Current minute
-        rtc.adjust(DateTime(now_now.unixtime() - 60));
-        pending_update = true;
-        break;
-    case 'S': // Current seconds
-        rtc.adjust(DateTime(now_now.unixtime() - 1));
-        pending_update = true;
-        break;
-    case 'p': // Current AM/PM
-        rtc.adjust(DateTime(now_now.unixtime() - 43200));
-        pending_update = true;
-        break;
-    case 'I': // Sunrise hour
-        tmp_byte = getSunriseHour(alarm_setup);
-        if (tmp_byte == 0)
+
+        tmp_byte = tz_dst;
+        adjustClock(DateTime(
+            2000 + fields[SET_CLOCK_YEAR],
+            fields[SET_CLOCK_MONTH],
+            fields[SET_CLOCK_DAY],
+            fields[SET_CLOCK_HOUR],
+            fields[SET_CLOCK_MINUTE],
+            fields[SET_CLOCK_SECOND]));
+
+        // Crossing a DST transition moves the hour shown, as in checkDst()
+        if (tz_dst != tmp_byte)
         {
-            tmp_byte = 24;
+            clearLcd();
         }
-        tmp_byte--;
-        writeEByte(alarm_setup, tmp_byte);
-        pending_update = true;
         break;
-    case 'N': // Sunrise minute
-        tmp_byte = getSunriseMin(alarm_setup);
-        if (tmp_byte == 0)
+    case SET_RAM:
+        *setting_ram[setting.target] = value;
+        if (setting.address != SET_NO_EEPROM)
         {
-            tmp_byte = 60;
+            writeEByte(setting.address, value);
         }
-        tmp_byte--;
-        setSunriseMin(alarm_setup, tmp_byte);
-        pending_update = true;
         break;
-    case 'q': // Sunrise AM/PM
-        tmp_byte = getSunriseHour(alarm_setup);
-        tmp_byte = (tmp_byte + 12) % 24;
-        writeEByte(alarm_setup, tmp_byte);
-        pending_update = true;
+    default:
+        writeEByte(setting.target + ((setting.flags & SET_PER_DAY) ? alarm_setup : 0), value);
         break;
     }
+}
+
+// Bring a value into the setting's range, wrapping around or clamping
+int settingFit(const Setting &setting, int value)
+{
+    int high = setting.high;
+    if (setting.flags & SET_MONTH_DAYS)
+    {
+        high = tzDaysInMonth(now_now.year(), now_now.month());
+    }
 
-    if (pending_update)
+    if (setting.flags & SET_WRAP)
     {
-        tft.background(bg_color.r, bg_color.g, bg_color.b);
-        now_now = rtc.now();
+        int span = high - setting.low + 1;
+        return setting.low + ((value - setting.low) % span + span) % span;
     }
+
+    return constrain(value, setting.low, high);
+}
+
+// Step the selected setting up (1) or down (-1)
+void adjustSetting(int8_t direction)
+{
+    Setting setting;
+    memcpy_P(&setting, &settings[setting_entry], sizeof(Setting));
+
+    settingWrite(setting, settingFit(setting, settingRead(setting) + direction * setting.step));
+
+    logEvent((direction > 0) ? EVT_SETTING_UP : EVT_SETTING_DOWN, setting.key);
+    clearLcd();
+    now_now = localNow();
+    syncMinuteOfWeek();
+    refreshAlarms();
 }
 
 void checkBtnOk()
@@ -504,18 +797,26 @@ void checkBtnOk()
         }
         else
         { // not in setup mode
+            logEvent(EVT_SNOOZE, sunrise_mode);
             turnLedsOff();
-            sunrise_mode = false;
-            sleep_mode = true;
+
+            // Only a running (or already snoozed) sunrise has anything to hold off
+            if (sunrise_minutes >= 0)
+            {
+                snooze();
+            }
         }
         break;
     case 2: // long press
         // toggle setup mode
         setup_mode = !setup_mode;
+        logEvent(EVT_SETUP_MODE, setup_mode);
+        timelineFade(LED_FADE_SETUP);
         // default selected alarm to today
         alarm_setup = now_now.dayOfTheWeek();
         sleep_mode = false;
-        tft.background(bg_color.r, bg_color.g, bg_color.b);
+        snooze_until = 0;
+        clearLcd();
         break;
     }
 }
@@ -532,7 +833,7 @@ void checkBtnLeft()
         if (setup_mode)
         { // in setup mode
             // adjust value
-            decreaseSettingsValue();
+            adjustSetting(-1);
         }
 
         break;
@@ -550,6 +851,7 @@ void checkBtnLeft()
         }
         else
         { // not in setup mode
+            logEvent(EVT_LEDS_OFF, 0);
             turnLedsOff();
         }
         break;
@@ -568,7 +870,7 @@ void checkBtnRight()
         if (setup_mode)
         { // in setup mode
             // adjust value
-            increaseSettingsValue();
+            adjustSetting(1);
         }
 
         break;
@@ -586,6 +888,7 @@ void checkBtnRight()
         }
         else
         { // not in setup mode
+            logEvent(EVT_LEDS_OFF, 0);
             turnLedsOff();
         }
         break;
@@ -602,7 +905,7 @@ void tftDrawInfo(byte x, byte y, String value, char setting, bool blank)
     if (setup_mode)
     { // in setup mode
         // Flash the settings entry that is currently selected
-        if (setting_entries_dict[setting_entry] == setting)
+        if (settingKey(setting_entry) == setting)
         {
             if ((now_now.second() % 2) == 0)
             {
@@ -832,6 +1135,8 @@ void drawNextSunrise(byte x, byte y)
 
         tft.stroke(punctuation_color.r, punctuation_color.g, punctuation_color.b);
         tft.text("Next Sunrise:", x, y);
+        tft.text("Snooze", x + 90, y);
+        tftDrawInfo(x + 130, y, String(sleep_timer) + "m", 'z', false);
         x = 25;
         y += 10;
 
@@ -855,23 +1160,40 @@ void drawNextSunrise(byte x, byte y)
         {
             tftDrawInfo(x, y, "AM", 'q', false);
         }
+        x += 20;
+        tft.stroke(punctuation_color.r, punctuation_color.g, punctuation_color.b);
+        tft.text("for", x, y);
+        x += 22;
+        tftDrawInfo(x, y, String(alarm_time) + "m", 'L', false);
+
+        // Solar mode and its offset from the real sunrise
+        x = 25;
+        y += 10;
+        tft.stroke(punctuation_color.r, punctuation_color.g, punctuation_color.b);
+        tft.text("Solar", x, y);
+        x += 35;
+        tftDrawInfo(x, y, solarEnabled() ? "On" : "Off", 'A', false);
+        x += 25;
+        int offset = solarOffset();
+        tftDrawInfo(x, y, (offset < 0 ? "" : "+") + String(offset) + "m", 'O', false);
 
         return;
     }
 
     // update this field once per minute when out of setup mode
-    if (now_now.minute() != now_last.minute())
+    if ((now_now.minute() != now_last.minute()) || lcd_repaint)
     {
-        tmp_byte = now_now.dayOfTheWeek();
-        int sr_minutes = getSunriseHour(tmp_byte) * 60 + getSunriseMin(tmp_byte);
-        int cur_minutes = now_now.hour() * 60 + now_now.minute();
-
         String message = "";
 
-        if (cur_minutes < sr_minutes)
+        if (sunrise_minutes >= 0)
+        {
+            // Current time is during sunrise
+            message = "The sun is rising";
+        }
+        else if (now_mow < alarm_mow[now_dow])
         {
             // Current time is before sunrise
-            tmp_byte = (sr_minutes - cur_minutes) / 60;
+            tmp_byte = (alarm_mow[now_dow] - now_mow) / 60;
             if (tmp_byte == 0)
             {
                 message = "Sunrise in less than an hour";
@@ -885,11 +1207,6 @@ void drawNextSunrise(byte x, byte y)
                 message = "Sunrise in " + String(tmp_byte) + " hours";
             }
         }
-        else if ((cur_minutes - sr_minutes) <= alarm_time)
-        {
-            // Current time is during sunrise
-            message = "The sun is rising";
-        }
         else
         {
             // The sun has risen
@@ -910,7 +1227,7 @@ void drawNextSunrise(byte x, byte y)
 void drawCurrentMode(byte x, byte y)
 {
     // Update every 15 seconds
-    if ((now_now.second() % 15 == 0) && now_now.second() != now_last.second())
+    if (((now_now.second() % 15 == 0) && now_now.second() != now_last.second()) || lcd_repaint)
     {
 
         String message = "Current mode:  ";
@@ -939,12 +1256,49 @@ void drawCurrentMode(byte x, byte y)
     }
 }
 
+/* Draw the idle clock
+      HH:MM in the middle of the screen, redrawn once a minute
+*/
+String idleClockText(DateTime &dtm)
+{
+    tmp_byte = dtm.hour() % 12;
+    if (tmp_byte == 0)
+    {
+        tmp_byte = 12;
+    }
+
+    return String(tmp_byte) + (dtm.minute() < 10 ? ":0" : ":") + String(dtm.minute());
+}
+
+void drawIdleClock(byte x, byte y)
+{
+    if ((now_now.minute() == now_last.minute()) && !lcd_repaint)
+    {
+        return;
+    }
+
+    tft.setTextSize(2);
+    if (!lcd_repaint)
+    {
+        tftDrawInfo(x, y, idleClockText(now_last), 'Z', true);
+    }
+    tftDrawInfo(x, y, idleClockText(now_now), 'Z', false);
+}
+
 // Update information displayed on LCD
 void updateLcd()
 {
     byte x = 5;
     byte y = 0;
 
+    checkIdle();
+    if (display_idle)
+    {
+        drawIdleClock(50, 56);
+        lcd_repaint = false;
+        return;
+    }
+
     /****************************** line 1 ******************************/
     tft.setTextSize(3);
     drawHour(x, y);
@@ -1014,7 +1368,187 @@ void updateLcd()
     y = 120;
     drawCurrentMode(x, y);
 
+    lcd_repaint = false;
+
     // /****************************** line 6 ******************************/
     // x = 80;
     // y = 120;
 }
+
+/* Profiling functions
+*/
+#ifdef TFT_PROFILE
+void profileDrawInfo(byte x, byte y)
+{
+    tftDrawInfo(x, y, 42, 'H', false);
+}
+
+// The bare commands checkIdle() and wakeDisplay() send, without their full screen clear
+void profileIdleMode(byte x, byte y)
+{
+    tftCommand(ST7735_IDMON);
+    tftCommand(ST7735_IDMOFF);
+}
+
+struct TftProfileEntry
+{
+    const char *name;
+    void (*draw)(byte, byte);
+    byte x;
+    byte y;
+    byte text_size;
+    uint16_t budget;
+};
+
+// Positions and text sizes match updateLcd()
+TftProfileEntry tft_profile_entries[] = {
+    {"tftDrawInfo", profileDrawInfo, 5, 0, 1, TFT_BUDGET_INFO},
+    {"drawHour", drawHour, 5, 0, 3, TFT_BUDGET_HOUR},
+    {"drawMinute", drawMinute, 47, 0, 3, TFT_BUDGET_MINUTE},
+    {"drawSecond", drawSecond, 89, 0, 3, TFT_BUDGET_SECOND},
+    {"drawAmPm", drawAmPm, 130, 5, 2, TFT_BUDGET_AMPM},
+    {"drawYear", drawYear, 10, 35, 2, TFT_BUDGET_YEAR},
+    {"drawMonth", drawMonth, 70, 35, 2, TFT_BUDGET_MONTH},
+    {"drawDay", drawDay, 108, 35, 2, TFT_BUDGET_DAY},
+    {"drawDoW", drawDoW, 50, 60, 1, TFT_BUDGET_DOW},
+    {"drawNextSunrise", drawNextSunrise, 0, 90, 1, TFT_BUDGET_NEXT_SUNRISE},
+    {"drawCurrentMode", drawCurrentMode, 0, 120, 1, TFT_BUDGET_CURRENT_MODE},
+    {"idleMode", profileIdleMode, 0, 0, 1, TFT_BUDGET_IDLE_MODE},
+};
+#define TFT_PROFILE_ENTRIES (sizeof(tft_profile_entries) / sizeof(tft_profile_entries[0]))
+
+// Profile modes:  clock, sleeping, sunrise, then setup with each setting selected
+#define TFT_PROFILE_MODES (3 + SETTINGS)
+
+void tftProfileMode(byte mode)
+{
+    setup_mode = (mode >= 3);
+    sleep_mode = (mode == 1);
+    sunrise_mode = (mode == 2);
+    sunrise_minutes = sunrise_mode ? (alarm_time / 2) : -1;
+    setting_entry = setup_mode ? (mode - 3) : 0;
+
+    if (setup_mode)
+    {
+        Serial.print("setup:");
+        Serial.print(settingKey(setting_entry));
+    }
+    else if (sleep_mode)
+    {
+        Serial.print("sleeping");
+    }
+    else if (sunrise_mode)
+    {
+        Serial.print("sunrise");
+    }
+    else
+    {
+        Serial.print("clock");
+    }
+}
+
+// Draw every element in every mode and report its traffic against the budget,
+// returns the number of element and mode pairs over budget
+byte tftProfileSweep()
+{
+    bool saved_setup = setup_mode;
+    bool saved_sleep = sleep_mode;
+    bool saved_sunrise = sunrise_mode;
+    int saved_minutes = sunrise_minutes;
+    byte saved_entry = setting_entry;
+    DateTime saved_now = now_now;
+    DateTime saved_last = now_last;
+
+    // Worst case frame:  11:59:59 -> 12:00:00 changes every field drawn per second
+    now_now = DateTime(saved_now.year(), saved_now.month(), saved_now.day(), 12, 0, 0);
+    now_last = DateTime(now_now.unixtime() - 1);
+
+    byte over = 0;
+    Serial.println("TFT element mode commands windows pixels us budget");
+    for (byte i = 0; i < TFT_PROFILE_ENTRIES; i++)
+    {
+        for (byte mode = 0; mode < TFT_PROFILE_MODES; mode++)
+        {
+            Serial.print("TFT ");
+            Serial.print(tft_profile_entries[i].name);
+            Serial.print(" ");
+            tftProfileMode(mode);
+
+            tft.setTextSize(tft_profile_entries[i].text_size);
+            tft_windows = 0;
+            tft_pixels = 0;
+            tft_commands = 0;
+            tft_profile_entries[i].draw(tft_profile_entries[i].x, tft_profile_entries[i].y);
+            uint32_t micros_on_wire = tftTrafficMicros();
+
+            Serial.print(" ");
+            Serial.print(tft_commands);
+            Serial.print(" ");
+            Serial.print(tft_windows);
+            Serial.print(" ");
+            Serial.print(tft_pixels);
+            Serial.print(" ");
+            Serial.print(micros_on_wire);
+            Serial.print(" ");
+            Serial.print(tft_profile_entries[i].budget);
+            if (micros_on_wire > tft_profile_entries[i].budget)
+            {
+                Serial.print(" OVER");
+                over++;
+            }
+            Serial.println();
+        }
+    }
+    Serial.print("TFT budget: ");
+    Serial.print(over);
+    Serial.println(" over");
+
+    setup_mode = saved_setup;
+    sleep_mode = saved_sleep;
+    sunrise_mode = saved_sunrise;
+    sunrise_minutes = saved_minutes;
+    setting_entry = saved_entry;
+    now_now = saved_now;
+    now_last = saved_last;
+    clearLcd();
+    return over;
+}
+#endif
+
+#include "./telemetry.h"
+
+/* Serial functions
+*/
+// Handle single character commands from the serial console
+void checkSerial()
+{
+    if (adalight_streaming || adalight_syncing)
+    {
+        adalightPoll();
+        return;
+    }
+
+    if (!Serial.available())
+    {
+        return;
+    }
+
+    switch (Serial.read())
+    {
+    case 'L': // Dump the event log
+        eventLogDump();
+        break;
+    case 'A': // Adalight frame, see adalight.h
+        adalightFrame();
+        break;
+    case 'T': // Toggle the telemetry stream
+        telemetry_enabled = !telemetry_enabled;
+        telemetry_pos = 0; // a frame cut short by turning it off is not resumed
+        break;
+#ifdef TFT_PROFILE
+    case 'P': // Profile TFT traffic
+        tftProfileSweep();
+        break;
+#endif
+    }
+}
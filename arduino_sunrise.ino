@@ -8,8 +8,53 @@
 */
 void setup()
 {
-  Serial.begin(115200);
-  Serial.println("Clock startup");
+  // Fast start:  get the strip to the right sunrise level before the slow
+  // serial and screen setup
+  halBegin();
+  ledSegmentsBegin();
+  loadSettings();
+
+  // Button Mode change
+  pinMode(BTN_OK, INPUT_PULLUP);
+  pinMode(BTN_LEFT, INPUT_PULLUP);
+  pinMode(BTN_RIGHT, INPUT_PULLUP);
+
+  // Set the RTC if necessary
+  bool rtc_found = rtc.begin();
+  bool rtc_reset = rtc_found && !rtc.isrunning();
+  if (rtc_reset)
+  {
+    // set the RTC to the date & time this sketch was compiled
+    adjustClock(DateTime(F(__DATE__), F(__TIME__)));
+  }
+
+  if (rtc_found)
+  {
+    now_std = rtc.now();
+    tzSync();
+    now_now = wallTime(now_std);
+    syncMinuteOfWeek();
+    refreshAlarms();
+
+    // Resume the event log where the last run left off
+    eventLogBegin();
+    logEvent(EVT_BOOT, rtc_reset);
+
+    // Resume an interrupted sunrise (and its snooze) and draw the first frame
+    restoreCheckpoint();
+    checkModeActive();
+    timelineStop(TL_FADE); // land on the right level straight away
+    updateLed();
+  }
+  unsigned long boot_frame_us = micros();
+
+  // Clear a stale snooze deadline now that the strip is up (3.3ms per EEPROM byte)
+  if (rtc_found)
+  {
+    saveCheckpoint();
+  }
+
+  Serial.begin(SERIAL_BAUD);
 
   pinMode(TFT_CS, OUTPUT);
   digitalWrite(TFT_CS, HIGH);
@@ -18,16 +63,8 @@ void setup()
   tft.setRotation(3);
   tft.background(bg_color.r, bg_color.g, bg_color.b);
 
-  // Define the LED strip driver and color calibration
-  FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
-
-  // Button Mode change
-  pinMode(BTN_OK, INPUT_PULLUP);
-  pinMode(BTN_LEFT, INPUT_PULLUP);
-  pinMode(BTN_RIGHT, INPUT_PULLUP);
-
   // Verify RTC exists
-  if (!rtc.begin())
+  if (!rtc_found)
   {
     Serial.println("Couldn't find RTC");
     tft.stroke(255, 0, 0);
@@ -36,17 +73,7 @@ void setup()
       ;
   }
 
-  // Set the RTC if necessary
-  if (!rtc.isrunning())
-  {
-    Serial.println("RTC not running!  Setting to last compile DateTime: " + String(F(__DATE__)) + " at " + String(F(__TIME__)));
-
-    // set the RTC to the date & time this sketch was compiled
-    rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
-  }
-
-  Serial.println("Setup complete!");
-  Serial.print("Current RTC Date/Time: ");
+  Serial.print("Clock startup ");
   Serial.print(now_now.year());
   Serial.print("/");
   Serial.print(now_now.month());
@@ -57,21 +84,30 @@ void setup()
   Serial.print(":");
   Serial.print(now_now.minute());
   Serial.print(":");
-  Serial.println(now_now.second());
-
-  Serial.print("Unix time: ");
-  Serial.println(now_now.unixtime());
+  Serial.print(now_now.second());
+  if (rtc_reset)
+  {
+    Serial.print(" (RTC reset to compile time)");
+  }
+  Serial.print(", first LED frame after ");
+  Serial.print(boot_frame_us);
+  Serial.println("us");
 }
 
 void loop()
 {
-  now_now = rtc.now();
+  now_now = localNow();
+  checkDst();
+  tickMinuteOfWeek();
 
   // Check if any buttons are being pressed
   checkBtnOk();
   checkBtnLeft();
   checkBtnRight();
 
+  // Serial console commands
+  checkSerial();
+
   // Sunrise currently active, sleeping, or off?
   checkModeActive();
 
@@ -81,5 +117,14 @@ void loop()
   // Update LCD
   updateLcd();
 
+  // Trickle queued events out to EEPROM
+  eventLogFlush();
+
+  // Stream the LED frame to the host viewer when enabled
+  telemetrySend();
+
+  // Board specific housekeeping
+  halPoll();
+
   now_last = now_now;
 }
@@ -0,0 +1,189 @@
+/* Event log
+    Append-only ring of packed 4 byte records kept in EEPROM.  Each record holds
+    an event code, a payload byte and the time elapsed since the previous
+    record:  seconds up to 9 hours, whole minutes (EVENT_LOG_MINUTES set) up to
+    22 days, so a clock with one alarm a day still spends a single record per
+    event.  A gap counted in minutes stamps its event up to 59s early, the next
+    delta starts from that stamp so nothing accumulates.  A pair of anchor
+    records carrying the full unixtime is written after boot, after the clock
+    is moved backwards, and whenever the gap is longer than that.
+
+    logEvent() only queues the record in RAM.  eventLogFlush() is called once per
+    loop and writes a single byte, and only when the EEPROM has finished the
+    previous write, so logging never stalls the loop.
+
+    Decode a dump (serial command 'L') with tools/event_log_decode.py
+*/
+#define EVENT_LOG_RECORD 4 // Bytes per record
+#define EVENT_LOG_SLOTS (EVENT_LOG_BYTES / EVENT_LOG_RECORD)
+#define EVENT_LOG_QUEUE 8     // Records held in RAM waiting to be flushed
+#define EVENT_LOG_EMPTY 0xFF  // Erased EEPROM
+#define EVENT_LOG_LAP 0x80    // Code bit flipped on every pass around the ring
+#define EVENT_LOG_MINUTES 0x8000 // Delta bit:  the low 15 bits count minutes, not seconds
+
+// Event codes (the low 7 bits of a record's code byte, 0x7F is reserved)
+#define EVT_TIME_HI 1        // delta = high word of unixtime
+#define EVT_TIME_LO 2        // delta = low word of unixtime
+#define EVT_BOOT 3           // payload = 1 if the RTC had to be reset
+#define EVT_SUNRISE_START 4  // payload = DoW of the alarm
+#define EVT_SUNRISE_END 5    // payload = DoW of the alarm
+#define EVT_SNOOZE 6         // payload = 1 if a sunrise was running
+#define EVT_SETUP_MODE 7     // payload = 1 entering, 0 leaving
+#define EVT_SETTING_UP 8     // payload = setting key
+#define EVT_SETTING_DOWN 9   // payload = setting key
+#define EVT_LEDS_OFF 10      // LEDs turned off by a long left/right press
+#define EVT_DST 11           // payload = 1 entering DST, 0 leaving
+#define EVT_STREAM 12        // payload = 1 Adalight stream started, 0 timed out
+#define EVT_SNOOZE_END 13    // payload = 1 if the sunrise resumes
+
+struct EventRecord
+{
+    byte code;      // event code | lap bit
+    byte payload;   // event specific
+    uint16_t delta; // seconds since the previous record, minutes with EVENT_LOG_MINUTES
+};
+
+EventRecord event_queue[EVENT_LOG_QUEUE];
+byte event_queue_tail = 0;   // oldest queued record
+byte event_queue_len = 0;    // number of queued records
+byte event_flush_byte = 0;   // bytes of the oldest queued record already written
+byte event_dropped = 0;      // records lost to a full queue
+uint16_t event_head = 0;     // next ring slot to write
+byte event_lap = 0;          // lap bit for records written on this pass
+uint32_t event_last_time = 0; // unixtime of the previous record (0 = anchor needed)
+
+// Locate the write position left by the previous run
+void eventLogBegin()
+{
+    byte code = halEepromRead(EEPROM_EVENT_LOG);
+    if (code == EVENT_LOG_EMPTY)
+    {
+        return;
+    }
+
+    // Records written on the current pass share a lap bit, the head is the
+    // first slot that is either erased or still carries the previous lap bit
+    event_lap = code & EVENT_LOG_LAP;
+    for (event_head = 1; event_head < EVENT_LOG_SLOTS; event_head++)
+    {
+        code = halEepromRead(EEPROM_EVENT_LOG + event_head * EVENT_LOG_RECORD);
+        if ((code == EVENT_LOG_EMPTY) || ((code & EVENT_LOG_LAP) != event_lap))
+        {
+            return;
+        }
+    }
+
+    // The whole ring belongs to one pass, start the next one
+    event_head = 0;
+    event_lap ^= EVENT_LOG_LAP;
+}
+
+void queueEventRecord(byte code, byte payload, uint16_t delta)
+{
+    EventRecord *record = &event_queue[(event_queue_tail + event_queue_len) % EVENT_LOG_QUEUE];
+    record->code = code;
+    record->payload = payload;
+    record->delta = delta;
+    event_queue_len++;
+}
+
+// Queue an event stamped with the current loop time
+void logEvent(byte code, byte payload)
+{
+    uint32_t now_time = now_now.unixtime();
+    uint32_t delta = now_time - event_last_time;
+    bool anchor = (event_last_time == 0) || (now_time < event_last_time) ||
+                  (delta >= EVENT_LOG_MINUTES * 60UL);
+
+    if ((event_queue_len + (anchor ? 3 : 1)) > EVENT_LOG_QUEUE)
+    {
+        if (event_dropped < 255)
+        {
+            event_dropped++;
+        }
+        return;
+    }
+
+    if (anchor)
+    {
+        queueEventRecord(EVT_TIME_HI, 0, now_time >> 16);
+        queueEventRecord(EVT_TIME_LO, 0, now_time & 0xFFFF);
+        delta = 0;
+    }
+    else if (delta >= EVENT_LOG_MINUTES)
+    {
+        // Whole minutes, the log's time moves on by exactly what was recorded
+        delta /= 60;
+        now_time = event_last_time + delta * 60;
+        delta |= EVENT_LOG_MINUTES;
+    }
+
+    queueEventRecord(code, payload, delta);
+    event_last_time = now_time;
+}
+
+// Write at most one queued byte, skipped while the EEPROM is still busy
+void eventLogFlush()
+{
+    if ((event_queue_len == 0) || !halEepromReady())
+    {
+        return;
+    }
+
+    EventRecord *record = &event_queue[event_queue_tail];
+    int address = EEPROM_EVENT_LOG + event_head * EVENT_LOG_RECORD;
+
+    // Write payload and delta first and the code byte last, a record torn by a
+    // reset still carries the old lap bit and is overwritten on the next boot
+    event_flush_byte++;
+    if (event_flush_byte < EVENT_LOG_RECORD)
+    {
+        halEepromWrite(address + event_flush_byte, ((byte *)record)[event_flush_byte]);
+        return;
+    }
+    halEepromWrite(address, record->code | event_lap);
+
+    event_flush_byte = 0;
+    event_queue_tail = (event_queue_tail + 1) % EVENT_LOG_QUEUE;
+    event_queue_len--;
+
+    event_head++;
+    if (event_head == EVENT_LOG_SLOTS)
+    {
+        event_head = 0;
+        event_lap ^= EVENT_LOG_LAP;
+    }
+}
+
+// Print the raw ring as hex, one record per line starting at slot 0
+void eventLogDump()
+{
+    // Blocking is fine here, the dump is only requested by hand
+    while (event_queue_len > 0)
+    {
+        eventLogFlush();
+    }
+
+    Serial.print("EVTLOG ");
+    Serial.print(EVENT_LOG_SLOTS);
+    Serial.print(" ");
+    Serial.print(event_head);
+    Serial.print(" ");
+    Serial.println(event_dropped);
+
+    for (uint16_t i = 0; i < EVENT_LOG_BYTES; i++)
+    {
+        tmp_byte = halEepromRead(EEPROM_EVENT_LOG + i);
+        if (tmp_byte < 0x10)
+        {
+            Serial.print("0");
+        }
+        Serial.print(tmp_byte, HEX);
+
+        if ((i % EVENT_LOG_RECORD) == (EVENT_LOG_RECORD - 1))
+        {
+            Serial.println();
+        }
+    }
+    Serial.println("EVTLOG END");
+}
@@ -0,0 +1,54 @@
+/* Hardware abstraction
+    The LEDs, buttons, EEPROM and raw screen commands go through the hal*()
+    calls below.  The RTC and the screen do not:  the sketch still uses the
+    global rtc and tft objects with the RTClib and Arduino TFT APIs, and each
+    backend only supplies classes with those APIs, so this is not a portable
+    core.  One backend is picked by the preprocessor, so every call resolves
+    at compile time to an inline function with no virtual dispatch:
+
+        hal_avr.h    Arduino Pro Mini, the original build
+        hal_esp32.h  ESP32, LED output runs on its own core (untested, see there)
+        hal_host.h   Desktop build for simulating the schedule (host/)
+
+    Every backend provides:
+        halBegin()                        once, first thing in setup()
+        halLedBegin(leds, count)          register the LED frame buffer
+        halLedSegment<PIN>(first, count)  drive leds[first] .. on one more pin
+        halLedShow(leds, count, bright)   push a frame to the strip
+        halButtonDown(pin)                true while a button is held
+        halEepromRead(address)            byte reads and writes, a write only
+        halEepromWrite(address, value)      touches the cell if it changed
+        halEepromReady()                  false while a previous write is busy
+        halEepromGet/Put(address, value)  whole structs
+        halTftCommand(cs, dc, command)    bare ST7735 command byte
+        halPoll()                         once per loop for backend housekeeping
+    and the TFT class and RTC_DS1307 used by the sketch.
+*/
+#if defined(ARDUINO_ARCH_AVR)
+#include "./hal_avr.h"
+#elif defined(ARDUINO_ARCH_ESP32)
+#include "./hal_esp32.h"
+#elif defined(SUNRISE_HOST)
+#include "./hal_host.h"
+#else
+#error "No hardware backend for this board"
+#endif
+
+// Copy a whole struct out of and into EEPROM
+template <class T>
+void halEepromGet(int address, T &value)
+{
+    for (uint16_t i = 0; i < sizeof(T); i++)
+    {
+        ((byte *)&value)[i] = halEepromRead(address + i);
+    }
+}
+
+template <class T>
+void halEepromPut(int address, const T &value)
+{
+    for (uint16_t i = 0; i < sizeof(T); i++)
+    {
+        halEepromWrite(address + i, ((const byte *)&value)[i]);
+    }
+}
@@ -0,0 +1,80 @@
+/* AVR backend
+    Arduino Pro Mini 5v 16mhz.  Everything runs on the one core, FastLED bit
+    bangs the strip with interrupts off and the EEPROM is the chip's own.
+    Segments on separate pins are sent one after the other, with interrupts
+    back on in between.
+*/
+//#include <Adafruit_GFX.h>    // LCD - Core graphics library
+//#include <Adafruit_ST7735.h> // LCD - Hardware-specific library
+#include <EEPROM.h> // Arduino's harddrive
+#include "RTClib.h" // RTC
+#include <SPI.h>    // LCD
+#include <TFT.h>    // LCD
+#include <Wire.h>   // RTC & LEDs
+#include <avr/eeprom.h> // eeprom_is_ready()
+
+#define FASTLED_ALLOW_INTERRUPTS 0
+#include <FastLED.h> // LEDs
+
+inline void halBegin()
+{
+}
+
+inline void halPoll()
+{
+}
+
+/* LEDs
+*/
+CRGB *hal_leds = NULL;
+
+inline void halLedBegin(CRGB *leds, uint16_t count)
+{
+    hal_leds = leds;
+}
+
+template <uint8_t PIN>
+void halLedSegment(uint16_t first, uint16_t count)
+{
+    FastLED.addLeds<WS2812B, PIN, GRB>(hal_leds + first, count);
+}
+
+inline void halLedShow(CRGB *leds, uint16_t count, byte brightness)
+{
+    FastLED.setBrightness(brightness);
+    FastLED.show();
+}
+
+/* Buttons (wired to ground, INPUT_PULLUP)
+*/
+inline bool halButtonDown(byte pin)
+{
+    return digitalRead(pin) == LOW;
+}
+
+/* EEPROM
+*/
+inline byte halEepromRead(int address)
+{
+    return EEPROM.read(address);
+}
+
+inline void halEepromWrite(int address, byte value)
+{
+    EEPROM.update(address, value);
+}
+
+inline bool halEepromReady()
+{
+    return eeprom_is_ready();
+}
+
+/* TFT
+*/
+inline void halTftCommand(byte cs, byte dc, byte command)
+{
+    digitalWrite(dc, LOW);
+    digitalWrite(cs, LOW);
+    SPI.transfer(command);
+    digitalWrite(cs, HIGH);
+}
@@ -0,0 +1,266 @@
+/* ESP32 backend
+    Dual core ESP32 on the Arduino core.  loop() and the screen stay on core 1
+    as usual and the strip is driven by a FreeRTOS task pinned to core 0, so a
+    ~5ms WS2812B frame never holds up the buttons or the screen, and screen
+    traffic never delays a frame.
+
+    Segments on separate pins go out on separate RMT channels at the same
+    time.
+
+    Frames are handed over through three buffers without a lock.  loop() owns
+    one to fill, the LED task owns the one being shown and the third holds the
+    newest complete frame.  Publishing and taking a frame are each a single
+    atomic exchange of that third buffer's index, so neither side ever waits
+    on the other and the task always shows the newest frame, skipping any it
+    did not get to.
+
+    The Arduino EEPROM library keeps the "EEPROM" in RAM and copies it to a
+    flash sector on commit().  Writes are committed from halPoll() at most
+    every HAL_EEPROM_COMMIT ms so the event log trickle does not wear the flash.
+
+    Wiring differs from the Pro Mini, the numbers it uses clash with the
+    ESP32's flash and strapping pins:
+        LED data 16 (segments 2 - 4: 13, 14, 32), OK 25, Left 26, Right 27
+        TFT CS 5, DC 17, RST 4, SCK 18, MOSI 23 (VSPI)
+        RTC SDA 21, SCL 22
+    The TFT library is AVR only, so TFT below adapts Adafruit_ST7735 to the
+    calls the sketch makes.
+
+    Untested:  this backend has only been syntax checked against stand-in
+    headers.  It has not been built with the ESP32 Arduino core or run on a
+    board.
+*/
+#include <EEPROM.h>
+#include "RTClib.h"
+#include <SPI.h>
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7735.h>
+#include <FastLED.h>
+#include <atomic>
+
+#define HAL_PINS
+#define DATA_PIN 16
+#define DATA_PIN_2 13
+#define DATA_PIN_3 14
+#define DATA_PIN_4 32
+#define BTN_OK 25
+#define BTN_LEFT 26
+#define BTN_RIGHT 27
+#define TFT_DC 17
+#define TFT_RST 4
+#define TFT_CS 5
+#define SD_CS 15
+
+#define HAL_EEPROM_SIZE 1024
+#define HAL_EEPROM_COMMIT 5000 // Milliseconds between flash commits
+#define HAL_LED_CORE 0
+#define HAL_LED_STACK 2048
+#define HAL_FRAME_FRESH 0x04 // Set on the shared index until the LED task takes the frame
+#define HAL_LED_SEGMENTS 4
+
+struct HalFrame
+{
+    CRGB *leds;
+    byte brightness;
+};
+
+HalFrame hal_frames[3];
+uint16_t hal_led_count = 0;
+byte hal_segments = 0;
+uint16_t hal_segment_first[HAL_LED_SEGMENTS];
+uint16_t hal_segment_count[HAL_LED_SEGMENTS];
+byte hal_fill = 0;                    // frame loop() writes next
+byte hal_shown = 1;                   // frame the LED task is showing
+std::atomic<byte> hal_newest(2);      // newest complete frame | HAL_FRAME_FRESH
+TaskHandle_t hal_led_task = NULL;
+
+bool hal_eeprom_dirty = false;
+unsigned long hal_eeprom_commit = 0; // millis() of the last commit
+
+void halBegin()
+{
+    EEPROM.begin(HAL_EEPROM_SIZE);
+}
+
+void halPoll()
+{
+    if (hal_eeprom_dirty && ((millis() - hal_eeprom_commit) >= HAL_EEPROM_COMMIT))
+    {
+        EEPROM.commit();
+        hal_eeprom_dirty = false;
+        hal_eeprom_commit = millis();
+    }
+}
+
+/* LEDs
+*/
+// LED core:  wait for a frame, swap it in and clock it out
+void halLedTask(void *)
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!(hal_newest.load() & HAL_FRAME_FRESH))
+        {
+            continue;
+        }
+
+        // Only this task clears the flag, so the frame is still fresh here
+        hal_shown = hal_newest.exchange(hal_shown) & 0x03;
+        for (byte i = 0; i < hal_segments; i++)
+        {
+            FastLED[i].setLeds(hal_frames[hal_shown].leds + hal_segment_first[i], hal_segment_count[i]);
+        }
+        FastLED.setBrightness(hal_frames[hal_shown].brightness);
+        FastLED.show();
+    }
+}
+
+void halLedBegin(CRGB *leds, uint16_t count)
+{
+    hal_led_count = count;
+    for (byte i = 0; i < 3; i++)
+    {
+        hal_frames[i].leds = new CRGB[count]();
+        hal_frames[i].brightness = 0;
+    }
+
+    xTaskCreatePinnedToCore(halLedTask, "leds", HAL_LED_STACK, NULL, 2, &hal_led_task, HAL_LED_CORE);
+}
+
+template <uint8_t PIN>
+void halLedSegment(uint16_t first, uint16_t count)
+{
+    hal_segment_first[hal_segments] = first;
+    hal_segment_count[hal_segments] = count;
+    hal_segments++;
+    FastLED.addLeds<WS2812B, PIN, GRB>(hal_frames[hal_shown].leds + first, count);
+}
+
+// UI core:  copy the frame out and publish it, never waits on the strip
+void halLedShow(CRGB *leds, uint16_t count, byte brightness)
+{
+    HalFrame *frame = &hal_frames[hal_fill];
+    memcpy(frame->leds, leds, count * sizeof(CRGB));
+    frame->brightness = brightness;
+
+    hal_fill = hal_newest.exchange(hal_fill | HAL_FRAME_FRESH) & 0x03;
+    xTaskNotifyGive(hal_led_task);
+}
+
+/* Buttons (wired to ground, INPUT_PULLUP)
+*/
+inline bool halButtonDown(byte pin)
+{
+    return digitalRead(pin) == LOW;
+}
+
+/* EEPROM
+*/
+inline byte halEepromRead(int address)
+{
+    return EEPROM.read(address);
+}
+
+inline void halEepromWrite(int address, byte value)
+{
+    if (EEPROM.read(address) != value)
+    {
+        EEPROM.write(address, value);
+        hal_eeprom_dirty = true;
+    }
+}
+
+inline bool halEepromReady()
+{
+    return true;
+}
+
+/* TFT
+*/
+inline void halTftCommand(byte cs, byte dc, byte command)
+{
+    SPI.beginTransaction(SPISettings(8000000, MSBFIRST, SPI_MODE0));
+    digitalWrite(dc, LOW);
+    digitalWrite(cs, LOW);
+    SPI.transfer(command);
+    digitalWrite(cs, HIGH);
+    SPI.endTransaction();
+}
+
+// The Arduino TFT library's drawing calls on top of Adafruit_ST7735
+class TFT : public Adafruit_ST7735
+{
+public:
+    TFT(int8_t cs, int8_t dc, int8_t rst) : Adafruit_ST7735(cs, dc, rst) {}
+
+    void begin()
+    {
+        initR(INITR_BLACKTAB);
+    }
+
+    void background(byte red, byte green, byte blue)
+    {
+        fillScreen(color565(red, green, blue));
+    }
+
+    void stroke(byte red, byte green, byte blue)
+    {
+        stroke_color = color565(red, green, blue);
+        use_stroke = true;
+    }
+
+    void noStroke()
+    {
+        use_stroke = false;
+    }
+
+    void fill(byte red, byte green, byte blue)
+    {
+        fill_color = color565(red, green, blue);
+        use_fill = true;
+    }
+
+    void noFill()
+    {
+        use_fill = false;
+    }
+
+    void text(const char *text, int16_t x, int16_t y)
+    {
+        if (!use_stroke)
+        {
+            return;
+        }
+        setTextColor(stroke_color);
+        setCursor(x, y);
+        print(text);
+    }
+
+    void rect(int16_t x, int16_t y, int16_t width, int16_t height)
+    {
+        if (use_fill)
+        {
+            fillRect(x, y, width, height, fill_color);
+        }
+        if (use_stroke)
+        {
+            drawRect(x, y, width, height, stroke_color);
+        }
+    }
+
+    void line(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+    {
+        if (use_stroke)
+        {
+            drawLine(x1, y1, x2, y2, stroke_color);
+        }
+    }
+
+private:
+    uint16_t stroke_color = 0xFFFF;
+    uint16_t fill_color = 0xFFFF;
+    bool use_stroke = true;
+    bool use_fill = true;
+};
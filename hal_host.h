@@ -0,0 +1,71 @@
+/* Host backend
+    Builds the sketch as a desktop program (host/sunrise_sim.cpp) to run the
+    schedule against a simulated clock.  host/ stands in for the Arduino core
+    and libraries with just what the sketch uses; the simulator owns time, the
+    RTC, the EEPROM image and the buttons, and the strip and screen draw
+    nowhere.
+*/
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <RTClib.h>
+#include <SPI.h>
+#include <TFT.h>
+#include <Wire.h>
+#include <FastLED.h>
+
+inline void halBegin()
+{
+}
+
+inline void halPoll()
+{
+}
+
+/* LEDs
+*/
+inline void halLedBegin(CRGB *leds, uint16_t count)
+{
+    FastLED.addLeds(leds, count);
+}
+
+template <uint8_t PIN>
+void halLedSegment(uint16_t first, uint16_t count)
+{
+    FastLED.segments++;
+}
+
+inline void halLedShow(CRGB *leds, uint16_t count, byte brightness)
+{
+    FastLED.setBrightness(brightness);
+    FastLED.show();
+}
+
+/* Buttons
+*/
+inline bool halButtonDown(byte pin)
+{
+    return digitalRead(pin) == LOW;
+}
+
+/* EEPROM
+*/
+inline byte halEepromRead(int address)
+{
+    return EEPROM.read(address);
+}
+
+inline void halEepromWrite(int address, byte value)
+{
+    EEPROM.update(address, value);
+}
+
+inline bool halEepromReady()
+{
+    return true;
+}
+
+/* TFT
+*/
+inline void halTftCommand(byte cs, byte dc, byte command)
+{
+}
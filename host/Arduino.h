@@ -0,0 +1,195 @@
+/* Arduino core for the host build
+    Only what the sketch uses.  Time and pins are driven by sunrise_sim.cpp.
+*/
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define F(text) (text)
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define memcpy_P memcpy
+
+#define lowByte(w) ((uint8_t)((w)&0xFF))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void pinMode(uint8_t pin, uint8_t mode);
+void hostBusTime(unsigned long us); // charge a bus transfer to micros()
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+class String
+{
+public:
+    String() {}
+    String(const char *text) : value(text) {}
+    String(char c) : value(1, c) {}
+    String(int number) : value(std::to_string(number)) {}
+    String(unsigned int number) : value(std::to_string(number)) {}
+    String(long number) : value(std::to_string(number)) {}
+    String(unsigned long number) : value(std::to_string(number)) {}
+
+    unsigned int length() const { return value.size(); }
+    const char *c_str() const { return value.c_str(); }
+
+    void toCharArray(char *buffer, unsigned int size) const
+    {
+        strncpy(buffer, value.c_str(), size);
+        buffer[size - 1] = 0;
+    }
+
+    String &operator+=(const String &other)
+    {
+        value += other.value;
+        return *this;
+    }
+
+    friend String operator+(const String &a, const String &b)
+    {
+        String joined(a);
+        return joined += b;
+    }
+
+private:
+    std::string value;
+};
+
+// Serial output goes to stdout when the simulator enables it, input comes
+// from a queue the simulator fills
+class HardwareSerial
+{
+public:
+    bool echo = false;
+    std::string input;
+
+    void begin(unsigned long baud) {}
+    int available() { return input.size(); }
+    int availableForWrite() { return echo ? 64 : 0; }
+
+    int read()
+    {
+        if (input.empty())
+        {
+            return -1;
+        }
+        int c = (byte)input[0];
+        input.erase(0, 1);
+        return c;
+    }
+
+    void setTimeout(unsigned long ms) { timeout = ms; }
+
+    // Stream's blocking reads:  an empty queue waits out the timeout in simulated time
+    size_t readBytes(char *buffer, size_t length)
+    {
+        size_t count = 0;
+        int c;
+        while ((count < length) && ((c = timedRead()) >= 0))
+        {
+            buffer[count++] = c;
+        }
+        return count;
+    }
+
+    bool find(char *target)
+    {
+        size_t length = strlen(target);
+        size_t matched = 0;
+        int c;
+        while ((c = timedRead()) >= 0)
+        {
+            matched = (c == target[matched]) ? matched + 1 : (c == target[0]);
+            if (matched == length)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t write(byte c) { return write(&c, 1); }
+    size_t write(const byte *buffer, size_t size)
+    {
+        if (echo)
+        {
+            fwrite(buffer, 1, size, stdout);
+        }
+        return size;
+    }
+
+    size_t print(const char *text) { return write((const byte *)text, strlen(text)); }
+    size_t print(const String &text) { return print(text.c_str()); }
+    size_t print(char c) { return write((byte)c); }
+    size_t print(unsigned long number, int base = DEC) { return printNumber(number, base); }
+    size_t print(unsigned int number, int base = DEC) { return printNumber(number, base); }
+    size_t print(byte number, int base = DEC) { return printNumber(number, base); }
+    size_t print(uint16_t number, int base = DEC) { return printNumber(number, base); }
+    size_t print(long number, int base = DEC)
+    {
+        if (number < 0)
+        {
+            return print('-') + printNumber(-number, base);
+        }
+        return printNumber(number, base);
+    }
+    size_t print(int number, int base = DEC) { return print((long)number, base); }
+    size_t print(int8_t number, int base = DEC) { return print((long)number, base); }
+
+    size_t println() { return print("\n"); }
+    template <class T>
+    size_t println(T value) { return print(value) + println(); }
+    template <class T>
+    size_t println(T value, int base) { return print(value, base) + println(); }
+
+private:
+    unsigned long timeout = 1000;
+
+    int timedRead()
+    {
+        int c = read();
+        if (c < 0)
+        {
+            delay(timeout);
+        }
+        return c;
+    }
+
+    size_t printNumber(unsigned long number, int base)
+    {
+        char buffer[24];
+        snprintf(buffer, sizeof(buffer), (base == HEX) ? "%lX" : "%lu", number);
+        return print(buffer);
+    }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,36 @@
+/* EEPROM for the host build, a 1KB image the simulator loads and saves
+*/
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include "Arduino.h"
+
+#define HOST_EEPROM_SIZE 1024
+#define HOST_EEPROM_WRITE_US 3300 // ATmega328P erase and write of one cell
+
+class EEPROMClass
+{
+public:
+    byte image[HOST_EEPROM_SIZE];
+    unsigned long writes = 0; // cells actually changed
+
+    byte read(int address) { return image[address]; }
+    void write(int address, byte value)
+    {
+        image[address] = value;
+        writes++;
+        hostBusTime(HOST_EEPROM_WRITE_US);
+    }
+    void update(int address, byte value)
+    {
+        if (image[address] != value)
+        {
+            write(address, value);
+        }
+    }
+    uint16_t length() { return HOST_EEPROM_SIZE; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,107 @@
+/* FastLED for the host build
+    CRGB and the lib8tion math the sketch uses, with FastLED's rounding.  The
+    strip itself is only a frame counter.
+*/
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+#include "Arduino.h"
+
+typedef uint8_t fract8;
+
+inline uint8_t scale8(uint8_t i, fract8 scale)
+{
+    return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+inline uint8_t lerp8by8(uint8_t a, uint8_t b, fract8 frac)
+{
+    return (b > a) ? a + scale8(b - a, frac) : a - scale8(a - b, frac);
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amount_of_b)
+{
+    uint16_t partial = (a << 8) | b;
+    partial -= a * amount_of_b;
+    partial += b * amount_of_b;
+    return partial >> 8;
+}
+
+inline uint8_t ease8InOutQuad(uint8_t i)
+{
+    uint8_t j = (i & 0x80) ? 255 - i : i;
+    uint8_t jj2 = scale8(j, j) << 1;
+    return (i & 0x80) ? 255 - jj2 : jj2;
+}
+
+struct CRGB
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    enum HTMLColorCode
+    {
+        Black = 0x000000,
+        DarkSlateGray = 0x2F4F4F,
+        LightGreen = 0x90EE90,
+        White = 0xFFFFFF,
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    CRGB(uint32_t code) : r(code >> 16), g(code >> 8), b(code) {}
+    CRGB(HTMLColorCode code) : CRGB((uint32_t)code) {}
+
+    uint8_t &operator[](uint8_t x) { return (&r)[x]; }
+    bool operator==(const CRGB &other) const { return (r == other.r) && (g == other.g) && (b == other.b); }
+    bool operator!=(const CRGB &other) const { return !(*this == other); }
+};
+
+inline CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amount_of_p2)
+{
+    return CRGB(blend8(p1.r, p2.r, amount_of_p2), blend8(p1.g, p2.g, amount_of_p2), blend8(p1.b, p2.b, amount_of_p2));
+}
+
+inline void fill_solid(CRGB *leds, int count, const CRGB &color)
+{
+    for (int i = 0; i < count; i++)
+    {
+        leds[i] = color;
+    }
+}
+
+class CFastLED
+{
+public:
+    CRGB *leds = NULL;
+    int count = 0;
+    unsigned long shows = 0;         // frames pushed to the strip
+    unsigned long first_show_us = 0; // micros() once the first frame is out
+    byte segments = 0;       // output pins
+
+    void addLeds(CRGB *data, int led_count)
+    {
+        leds = data;
+        count = led_count;
+    }
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() { return brightness; }
+    // WS2812B:  24 bits at 1.25us per LED, then the 50us latch
+    void show()
+    {
+        shows++;
+        hostBusTime(count * 30UL + 50);
+        if (shows == 1)
+        {
+            first_show_us = micros();
+        }
+    }
+
+private:
+    uint8_t brightness = 255;
+};
+
+extern CFastLED FastLED;
+
+#endif
@@ -0,0 +1,132 @@
+/* RTClib for the host build
+    DateTime follows the library (2000 - 2099), the DS1307 reads the
+    simulator's clock.
+*/
+#ifndef HOST_RTCLIB_H
+#define HOST_RTCLIB_H
+
+#include "Arduino.h"
+
+#define SECONDS_FROM_1970_TO_2000 946684800
+
+class DateTime
+{
+public:
+    DateTime(uint32_t t = SECONDS_FROM_1970_TO_2000)
+    {
+        t -= SECONDS_FROM_1970_TO_2000;
+        ss = t % 60;
+        t /= 60;
+        mm = t % 60;
+        t /= 60;
+        hh = t % 24;
+        uint16_t days = t / 24;
+        byte leap;
+        for (yOff = 0;; yOff++)
+        {
+            leap = (yOff % 4) == 0;
+            if (days < 365 + leap)
+            {
+                break;
+            }
+            days -= 365 + leap;
+        }
+        for (m = 1; m < 12; m++)
+        {
+            byte month_days = daysInMonth(m);
+            if (leap && (m == 2))
+            {
+                month_days++;
+            }
+            if (days < month_days)
+            {
+                break;
+            }
+            days -= month_days;
+        }
+        d = days + 1;
+    }
+
+    DateTime(uint16_t year, byte month, byte day, byte hour = 0, byte min = 0, byte sec = 0)
+        : yOff(year >= 2000 ? year - 2000 : year), m(month), d(day), hh(hour), mm(min), ss(sec) {}
+
+    // __DATE__ ("Oct 30 2019") and __TIME__ ("06:00:00")
+    DateTime(const char *date, const char *time)
+    {
+        static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+        yOff = atoi(date + 9);
+        m = (strstr(months, std::string(date, 3).c_str()) - months) / 3 + 1;
+        d = atoi(date + 4);
+        hh = atoi(time);
+        mm = atoi(time + 3);
+        ss = atoi(time + 6);
+    }
+
+    uint16_t year() const { return 2000 + yOff; }
+    byte month() const { return m; }
+    byte day() const { return d; }
+    byte hour() const { return hh; }
+    byte minute() const { return mm; }
+    byte second() const { return ss; }
+    byte dayOfTheWeek() const { return (days() + 6) % 7; } // Jan 1, 2000 was a Saturday
+
+    uint32_t unixtime() const
+    {
+        return ((days() * 24UL + hh) * 60 + mm) * 60 + ss + SECONDS_FROM_1970_TO_2000;
+    }
+
+private:
+    byte yOff, m, d, hh, mm, ss;
+
+    static byte daysInMonth(byte month)
+    {
+        static const byte days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return days_in_month[month - 1];
+    }
+
+    // Days since Jan 1, 2000
+    uint16_t days() const
+    {
+        uint16_t days = d;
+        for (byte i = 1; i < m; i++)
+        {
+            days += daysInMonth(i);
+        }
+        if ((m > 2) && ((yOff % 4) == 0))
+        {
+            days++;
+        }
+        return days + 365 * yOff + (yOff + 3) / 4 - 1;
+    }
+};
+
+// Simulated DS1307:  runs from the simulator's clock while not halted, each
+// call charges its transfer at the Wire default 100kHz (9 bits per byte)
+#define HOST_I2C_BYTE_US 90
+
+uint32_t hostRtcTime();
+void hostRtcAdjust(uint32_t t);
+bool hostRtcRunning();
+
+class RTC_DS1307
+{
+public:
+    bool begin() { return true; }
+    bool isrunning()
+    {
+        hostBusTime(4 * HOST_I2C_BYTE_US); // address, register, address, seconds
+        return hostRtcRunning();
+    }
+    void adjust(const DateTime &dt)
+    {
+        hostBusTime(9 * HOST_I2C_BYTE_US); // address, register, 7 time registers
+        hostRtcAdjust(dt.unixtime());
+    }
+    DateTime now()
+    {
+        hostBusTime(10 * HOST_I2C_BYTE_US); // address, register, address, 7 time registers
+        return DateTime(hostRtcTime());
+    }
+};
+
+#endif
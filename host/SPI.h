@@ -0,0 +1,17 @@
+/* SPI for the host build, nothing is attached
+*/
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+class SPIClass
+{
+public:
+    void begin() {}
+    byte transfer(byte data) { return 0; }
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,246 @@
+/* TFT library for the host build
+    Draws nowhere, but breaks every call down the way the Arduino TFT library
+    (its Adafruit_GFX fork) does:  text is rasterised from the classic 5x7
+    font one drawPixel() (or size x size fillRect()) per lit dot, rect() is a
+    fillRect() plus four fast lines, background() a full screen fillRect().
+    The primitives are virtual as in Adafruit_GFX, so MeteredTFT
+    (TFT_PROFILE) counts the same traffic here as on the board, and each
+    charges its address window and pixels to micros() at the 4MHz SPI clock.
+*/
+#ifndef HOST_TFT_H
+#define HOST_TFT_H
+
+#include "Arduino.h"
+
+// Adafruit GFX glcdfont, printable ASCII (0x20 - 0x7E), 5 columns per glyph, LSB at the top
+static const uint8_t host_tft_font[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, // ' '
+    0x00, 0x00, 0x5F, 0x00, 0x00, // !
+    0x00, 0x07, 0x00, 0x07, 0x00, // "
+    0x14, 0x7F, 0x14, 0x7F, 0x14, // #
+    0x24, 0x2A, 0x7F, 0x2A, 0x12, // $
+    0x23, 0x13, 0x08, 0x64, 0x62, // %
+    0x36, 0x49, 0x56, 0x20, 0x50, // &
+    0x00, 0x08, 0x07, 0x03, 0x00, // '
+    0x00, 0x1C, 0x22, 0x41, 0x00, // (
+    0x00, 0x41, 0x22, 0x1C, 0x00, // )
+    0x2A, 0x1C, 0x7F, 0x1C, 0x2A, // *
+    0x08, 0x08, 0x3E, 0x08, 0x08, // +
+    0x00, 0x80, 0x70, 0x30, 0x00, // ,
+    0x08, 0x08, 0x08, 0x08, 0x08, // -
+    0x00, 0x00, 0x60, 0x60, 0x00, // .
+    0x20, 0x10, 0x08, 0x04, 0x02, // /
+    0x3E, 0x51, 0x49, 0x45, 0x3E, // 0
+    0x00, 0x42, 0x7F, 0x40, 0x00, // 1
+    0x72, 0x49, 0x49, 0x49, 0x46, // 2
+    0x21, 0x41, 0x49, 0x4D, 0x33, // 3
+    0x18, 0x14, 0x12, 0x7F, 0x10, // 4
+    0x27, 0x45, 0x45, 0x45, 0x39, // 5
+    0x3C, 0x4A, 0x49, 0x49, 0x31, // 6
+    0x41, 0x21, 0x11, 0x09, 0x07, // 7
+    0x36, 0x49, 0x49, 0x49, 0x36, // 8
+    0x46, 0x49, 0x49, 0x29, 0x1E, // 9
+    0x00, 0x00, 0x14, 0x00, 0x00, // :
+    0x00, 0x40, 0x34, 0x00, 0x00, // ;
+    0x00, 0x08, 0x14, 0x22, 0x41, // <
+    0x14, 0x14, 0x14, 0x14, 0x14, // =
+    0x00, 0x41, 0x22, 0x14, 0x08, // >
+    0x02, 0x01, 0x59, 0x09, 0x06, // ?
+    0x3E, 0x41, 0x5D, 0x59, 0x4E, // @
+    0x7C, 0x12, 0x11, 0x12, 0x7C, // A
+    0x7F, 0x49, 0x49, 0x49, 0x36, // B
+    0x3E, 0x41, 0x41, 0x41, 0x22, // C
+    0x7F, 0x41, 0x41, 0x41, 0x3E, // D
+    0x7F, 0x49, 0x49, 0x49, 0x41, // E
+    0x7F, 0x09, 0x09, 0x09, 0x01, // F
+    0x3E, 0x41, 0x41, 0x51, 0x73, // G
+    0x7F, 0x08, 0x08, 0x08, 0x7F, // H
+    0x00, 0x41, 0x7F, 0x41, 0x00, // I
+    0x20, 0x40, 0x41, 0x3F, 0x01, // J
+    0x7F, 0x08, 0x14, 0x22, 0x41, // K
+    0x7F, 0x40, 0x40, 0x40, 0x40, // L
+    0x7F, 0x02, 0x1C, 0x02, 0x7F, // M
+    0x7F, 0x04, 0x08, 0x10, 0x7F, // N
+    0x3E, 0x41, 0x41, 0x41, 0x3E, // O
+    0x7F, 0x09, 0x09, 0x09, 0x06, // P
+    0x3E, 0x41, 0x51, 0x21, 0x5E, // Q
+    0x7F, 0x09, 0x19, 0x29, 0x46, // R
+    0x26, 0x49, 0x49, 0x49, 0x32, // S
+    0x03, 0x01, 0x7F, 0x01, 0x03, // T
+    0x3F, 0x40, 0x40, 0x40, 0x3F, // U
+    0x1F, 0x20, 0x40, 0x20, 0x1F, // V
+    0x3F, 0x40, 0x38, 0x40, 0x3F, // W
+    0x63, 0x14, 0x08, 0x14, 0x63, // X
+    0x03, 0x04, 0x78, 0x04, 0x03, // Y
+    0x61, 0x59, 0x49, 0x4D, 0x43, // Z
+    0x00, 0x7F, 0x41, 0x41, 0x41, // [
+    0x02, 0x04, 0x08, 0x10, 0x20, // backslash
+    0x00, 0x41, 0x41, 0x41, 0x7F, // ]
+    0x04, 0x02, 0x01, 0x02, 0x04, // ^
+    0x40, 0x40, 0x40, 0x40, 0x40, // _
+    0x00, 0x03, 0x07, 0x08, 0x00, // `
+    0x20, 0x54, 0x54, 0x78, 0x40, // a
+    0x7F, 0x28, 0x44, 0x44, 0x38, // b
+    0x38, 0x44, 0x44, 0x44, 0x28, // c
+    0x38, 0x44, 0x44, 0x28, 0x7F, // d
+    0x38, 0x54, 0x54, 0x54, 0x18, // e
+    0x00, 0x08, 0x7E, 0x09, 0x02, // f
+    0x18, 0xA4, 0xA4, 0x9C, 0x78, // g
+    0x7F, 0x08, 0x04, 0x04, 0x78, // h
+    0x00, 0x44, 0x7D, 0x40, 0x00, // i
+    0x20, 0x40, 0x40, 0x3D, 0x00, // j
+    0x7F, 0x10, 0x28, 0x44, 0x00, // k
+    0x00, 0x41, 0x7F, 0x40, 0x00, // l
+    0x7C, 0x04, 0x78, 0x04, 0x78, // m
+    0x7C, 0x08, 0x04, 0x04, 0x78, // n
+    0x38, 0x44, 0x44, 0x44, 0x38, // o
+    0xFC, 0x18, 0x24, 0x24, 0x18, // p
+    0x18, 0x24, 0x24, 0x18, 0xFC, // q
+    0x7C, 0x08, 0x04, 0x04, 0x08, // r
+    0x48, 0x54, 0x54, 0x54, 0x24, // s
+    0x04, 0x04, 0x3F, 0x44, 0x24, // t
+    0x3C, 0x40, 0x40, 0x20, 0x7C, // u
+    0x1C, 0x20, 0x40, 0x20, 0x1C, // v
+    0x3C, 0x40, 0x30, 0x40, 0x3C, // w
+    0x44, 0x28, 0x10, 0x28, 0x44, // x
+    0x4C, 0x90, 0x90, 0x90, 0x7C, // y
+    0x44, 0x64, 0x54, 0x4C, 0x44, // z
+    0x00, 0x08, 0x36, 0x41, 0x00, // {
+    0x00, 0x00, 0x77, 0x00, 0x00, // |
+    0x00, 0x41, 0x36, 0x08, 0x00, // }
+    0x02, 0x01, 0x02, 0x04, 0x02, // ~
+};
+
+class TFT
+{
+public:
+    TFT(byte cs, byte dc, byte rst) {}
+    virtual ~TFT() {}
+
+    void begin() {}
+    void setRotation(byte rotation) {}
+    void setTextSize(byte size) { text_size = (size > 0) ? size : 1; }
+    int16_t width() { return 160; }
+    int16_t height() { return 128; }
+
+    unsigned long clears = 0; // background() calls, for the simulator's repaint check
+
+    void background(byte red, byte green, byte blue)
+    {
+        clears++;
+        fillRect(0, 0, width(), height(), 0);
+    }
+    void stroke(byte red, byte green, byte blue) { use_stroke = true; }
+    void noStroke() { use_stroke = false; }
+    void fill(byte red, byte green, byte blue) { use_fill = true; }
+    void noFill() { use_fill = false; }
+
+    // Foreground dots only:  text() sets the background color to the stroke color
+    void text(const char *text, int16_t x, int16_t y)
+    {
+        if (!use_stroke)
+        {
+            return;
+        }
+
+        for (; *text; text++)
+        {
+            if (*text == '\n')
+            {
+                x = 0;
+                y += text_size * 8;
+                continue;
+            }
+            drawChar(x, y, *text);
+            x += text_size * 6;
+        }
+    }
+
+    void rect(int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+        if (use_fill)
+        {
+            fillRect(x, y, w, h, 0);
+        }
+        if (use_stroke)
+        {
+            drawFastHLine(x, y, w, 0);
+            drawFastHLine(x, y + h - 1, w, 0);
+            drawFastVLine(x, y, h, 0);
+            drawFastVLine(x + w - 1, y, h, 0);
+        }
+    }
+
+    void line(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+    {
+        if (!use_stroke)
+        {
+            return;
+        }
+
+        if (y1 == y2)
+        {
+            drawFastHLine(min(x1, x2), y1, abs(x2 - x1) + 1, 0);
+        }
+        else if (x1 == x2)
+        {
+            drawFastVLine(x1, min(y1, y2), abs(y2 - y1) + 1, 0);
+        }
+        else
+        {
+            // Bresenham, one pixel per step along the longer axis
+            int16_t steps = max(abs(x2 - x1), abs(y2 - y1));
+            for (int16_t i = 0; i <= steps; i++)
+            {
+                drawPixel(x1 + (x2 - x1) * i / steps, y1 + (y2 - y1) * i / steps, 0);
+            }
+        }
+    }
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) { spi(1); }
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { spi(h); }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { spi(w); }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { spi((uint32_t)w * h); }
+
+private:
+    byte text_size = 1;
+    bool use_stroke = true;
+    bool use_fill = true;
+
+    // 11 window bytes (CASET, RASET, RAMWR) and 2 per pixel, 2us a byte
+    void spi(uint32_t pixels)
+    {
+        hostBusTime((11 + pixels * 2) * 2);
+    }
+
+    void drawChar(int16_t x, int16_t y, char c)
+    {
+        if ((c < 0x20) || (c > 0x7E))
+        {
+            c = '?';
+        }
+        const uint8_t *glyph = &host_tft_font[(c - 0x20) * 5];
+
+        // Column 6 is the blank gap between glyphs
+        for (byte i = 0; i < 5; i++)
+        {
+            for (byte j = 0, column = glyph[i]; j < 8; j++, column >>= 1)
+            {
+                if (!(column & 1))
+                {
+                    continue;
+                }
+                if (text_size == 1)
+                {
+                    drawPixel(x + i, y + j, 0);
+                }
+                else
+                {
+                    fillRect(x + i * text_size, y + j * text_size, text_size, text_size, 0);
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,8 @@
+/* Wire for the host build, the RTC is simulated in RTClib.h
+*/
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+#endif
@@ -0,0 +1,187 @@
+#!/bin/sh
+# Scripted scenarios for the host simulator, run from the repository root:
+#     host/run_tests.sh
+# Each scenario runs the sketch in accelerated time and checks its --expect
+# lines (see sunrise_sim.cpp); the script exits non-zero if any fails.
+#
+# Times given to --start are RTC (standard) time, --press and --expect use the
+# wall clock.  solar_table.h sunrises (standard time):  Jan 15 07:11, Mar 7
+# 06:08, Mar 8 06:07, Jul 1 04:12, Oct 31 06:17, Nov 1 06:18.  Ramp brightness for a 60 minute sunrise is
+# map(elapsed, 0, 60, 5, 255):  10m 46, 35m 150, 40m 171, 60m 255.
+
+cd "$(dirname "$0")/.." || exit 1
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+sim="$work/sunrise_sim"
+g++ -std=gnu++11 -Wall -Werror -DSUNRISE_HOST -Ihost -o "$sim" host/sunrise_sim.cpp || exit 1
+
+passed=0
+failed=0
+
+# scenario NAME SIM_OPTIONS...
+scenario()
+{
+    name=$1
+    shift
+    if "$sim" "$@" > /dev/null 2> "$work/trace"; then
+        passed=$((passed + 1))
+        echo "pass  $name"
+    else
+        failed=$((failed + 1))
+        echo "FAIL  $name"
+        grep -E '^(FAIL|ok  )' "$work/trace" | sed 's/^/      /'
+    fi
+}
+
+# Snooze (one OK press, the screen is idle by then but the press still counts)
+
+scenario "snooze twice, each resumes at the elapsed brightness" \
+    --start "2019-11-10 05:00" --alarm 06:00 --minutes 125 \
+    --press ok@06:20 --press ok@06:45 \
+    --expect "2019-11-10 06:10:00 sunrise 46" \
+    --expect "2019-11-10 06:20:05 sleep" \
+    --expect "2019-11-10 06:35:00 sleep" \
+    --expect "2019-11-10 06:35:04 sunrise 150" \
+    --expect "2019-11-10 06:45:05 sleep" \
+    --expect "2019-11-10 07:00:00 sleep" \
+    --expect "2019-11-10 07:00:04 sunrise 255" \
+    --expect "2019-11-10 07:01:30 clock"
+
+scenario "reboot before the snooze, sets the deadline" \
+    --start "2019-11-10 05:00" --alarm 06:00 --minutes 85 \
+    --press ok@06:20 --eeprom "$work/reboot.eeprom" \
+    --expect "2019-11-10 06:24:00 sleep"
+scenario "reboot mid-snooze, restores the deadline" \
+    --start "2019-11-10 06:27" --minutes 15 --eeprom "$work/reboot.eeprom" --expect-boot 7000 \
+    --expect "2019-11-10 06:27:30 sleep" \
+    --expect "2019-11-10 06:35:00 sleep" \
+    --expect "2019-11-10 06:35:04 sunrise 150"
+scenario "stale snooze deadline is ignored" \
+    --start "2019-11-10 05:50" --minutes 2 --eeprom "$work/reboot.eeprom" \
+    --expect "2019-11-10 05:51:00 clock"
+
+# Boot to the first LED frame:  RTC reads, the 150 LED frame and no EEPROM
+# writes (5.8ms in the simulator, a write costs 3.3ms a byte)
+head -c 1024 /dev/zero | tr '\0' '\377' > "$work/blank.eeprom"
+scenario "first LED frame from a blank EEPROM without writes" \
+    --start "2019-11-10 05:00" --minutes 1 --eeprom "$work/blank.eeprom" --expect-boot 7000
+
+scenario "snooze across midnight" \
+    --start "2019-11-10 23:30" --alarm 23:50 --minutes 90 \
+    --press ok@00:10 \
+    --expect "2019-11-10 23:55:00 sunrise 25" \
+    --expect "2019-11-11 00:10:05 sleep" \
+    --expect "2019-11-11 00:25:00 sleep" \
+    --expect "2019-11-11 00:25:04 sunrise 150" \
+    --expect "2019-11-11 00:51:00 clock"
+
+scenario "snooze across spring forward" \
+    --start "2020-03-08 01:00" --alarm 01:30 --minutes 150 \
+    --press ok@01:50 \
+    --expect "2020-03-08 01:50:05 sleep" \
+    --expect "2020-03-08 03:05:00 sleep" \
+    --expect "2020-03-08 03:05:04 sunrise 150"
+
+scenario "snooze across fall back" \
+    --start "2019-11-03 00:00" --alarm 01:30 --minutes 150 \
+    --press ok@01:55 \
+    --expect "2019-11-03 01:55:05 sleep" \
+    --expect "2019-11-03 01:10:00 sleep" \
+    --expect "2019-11-03 01:10:04 sunrise 171"
+
+# Daylight saving time (US rules in tz.h)
+
+scenario "alarm inside the skipped spring hour starts at the jump" \
+    --start "2020-03-08 01:00" --alarm 02:30 --minutes 240 \
+    --expect "2020-03-08 01:59:00 clock" \
+    --expect "2020-03-08 03:00:30 sunrise 5" \
+    --expect "2020-03-08 03:10:00 sunrise 46" \
+    --expect "2020-03-08 04:01:30 clock"
+
+scenario "sunrise across fall back finishes on time and does not repeat" \
+    --start "2019-11-03 00:00" --alarm 01:30 --minutes 240 \
+    --expect "2019-11-03 01:45:00 sunrise 67" \
+    --expect "2019-11-03 01:05:00 sunrise 150" \
+    --expect "2019-11-03 01:31:30 clock" \
+    --expect "2019-11-03 01:45:00 clock" \
+    --expect "2019-11-03 02:30:00 clock"
+
+scenario "screen is redrawn when the clock springs forward" \
+    --start "2019-03-10 01:30" --minutes 60 \
+    --expect "2019-03-10 01:58:00 clock" \
+    --expect "2019-03-10 03:00:00 repaint" \
+    --expect "2019-03-10 03:10:00 clock"
+
+scenario "screen is redrawn when the clock falls back" \
+    --start "2019-11-03 00:30" --minutes 60 \
+    --expect "2019-11-03 01:58:00 clock" \
+    --expect "2019-11-03 01:00:30 repaint"
+
+# dst_year SPRING DAY_AFTER FALL DAY_AFTER
+#   A 06:00 alarm keeps to the wall clock on and after both transitions
+dst_year()
+{
+    scenario "06:00 alarm around spring forward $1" \
+        --start "$1 00:00" --alarm 06:00 --minutes 2880 \
+        --expect "$1 05:59:00 clock" \
+        --expect "$1 06:00:30 sunrise 5" \
+        --expect "$1 06:30:00 sunrise 130" \
+        --expect "$1 07:01:30 clock" \
+        --expect "$2 05:59:00 clock" \
+        --expect "$2 06:00:30 sunrise 5"
+    scenario "06:00 alarm around fall back $3" \
+        --start "$3 00:00" --alarm 06:00 --minutes 2880 \
+        --expect "$3 05:59:00 clock" \
+        --expect "$3 06:00:30 sunrise 5" \
+        --expect "$3 06:30:00 sunrise 130" \
+        --expect "$3 07:01:30 clock" \
+        --expect "$4 05:59:00 clock" \
+        --expect "$4 06:00:30 sunrise 5"
+}
+
+dst_year 2020-03-08 2020-03-09 2020-11-01 2020-11-02
+dst_year 2024-03-10 2024-03-11 2024-11-03 2024-11-04
+dst_year 2027-03-14 2027-03-15 2027-11-07 2027-11-08
+dst_year 2033-03-13 2033-03-14 2033-11-06 2033-11-07
+dst_year 2038-03-14 2038-03-15 2038-11-07 2038-11-08
+
+# Solar mode (solar_table.h:  Boston, UTC-5).  The table is in standard time,
+# the sunrise has to land on the wall clock
+scenario "solar sunrise in winter" \
+    --start "2020-01-15 05:00" --solar 0 --minutes 180 \
+    --expect "2020-01-15 07:10:30 clock" \
+    --expect "2020-01-15 07:11:30 sunrise 5"
+
+scenario "solar sunrise in summer is on daylight time" \
+    --start "2020-07-01 03:00" --solar 0 --minutes 180 \
+    --expect "2020-07-01 04:12:30 clock" \
+    --expect "2020-07-01 05:11:30 clock" \
+    --expect "2020-07-01 05:12:30 sunrise 5"
+
+scenario "solar sunrise with an offset across spring forward" \
+    --start "2020-03-07 05:00" --solar -30 --minutes 1800 \
+    --expect "2020-03-07 05:38:30 sunrise 5" \
+    --expect "2020-03-08 06:36:30 clock" \
+    --expect "2020-03-08 06:37:30 sunrise 5"
+
+scenario "solar sunrise across fall back" \
+    --start "2020-10-31 05:00" --solar 0 --minutes 1800 \
+    --expect "2020-10-31 07:17:30 sunrise 5" \
+    --expect "2020-11-01 06:17:30 clock" \
+    --expect "2020-11-01 06:18:30 sunrise 5"
+
+# TFT traffic:  every element in every mode within its tft_profile.h budget
+g++ -std=gnu++11 -Wall -Werror -DSUNRISE_HOST -DTFT_PROFILE -Ihost -o "$work/sunrise_prof" host/sunrise_sim.cpp || exit 1
+if "$work/sunrise_prof" --start "2019-11-10 05:00" --tft-profile > "$work/profile" 2>&1; then
+    passed=$((passed + 1))
+    echo "pass  TFT traffic within budget"
+else
+    failed=$((failed + 1))
+    echo "FAIL  TFT traffic within budget"
+    grep 'OVER' "$work/profile" | sed 's/^/      /'
+fi
+
+echo "$passed passed, $failed failed"
+[ "$failed" -eq 0 ]
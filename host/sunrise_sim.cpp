@@ -0,0 +1,489 @@
+/* Host simulator
+    Runs the unmodified sketch on a PC against a simulated clock, RTC, EEPROM
+    and buttons, so a week of schedule takes seconds.  A line is printed to
+    stderr whenever the LED brightness or the mode changes.
+
+    Build from the repository root:
+        g++ -std=gnu++11 -Wall -DSUNRISE_HOST -Ihost -o sunrise_sim host/sunrise_sim.cpp
+
+    ./sunrise_sim [options]
+        --start "YYYY-MM-DD HH:MM"  RTC (standard) time at boot, default 2019-10-30 05:00
+        --alarm HH:MM               sunrise time for every day of the week
+        --solar OFFSET              solar mode, sunrise OFFSET minutes from the real one
+        --minutes N                 simulated run length, default 1440
+        --step MS                   simulated time per loop(), default 1000
+        --press BUTTON@HH:MM[:S]    hold ok, left or right for S seconds (default 0.2)
+                                    at that wall time, may be repeated
+        --send CHARS                queue serial input, e.g. T for telemetry
+        --send-file FILE            queue the bytes of FILE, e.g. captured Adalight frames
+        --serial                    copy the sketch's serial output to stdout
+        --tft-profile               (built with -DTFT_PROFILE) run the TFT traffic sweep
+                                    after setup() instead of the schedule, exit 1 if
+                                    any element is over its budget
+        --eeprom FILE               load the EEPROM image from FILE and save it on exit
+        --expect "YYYY-MM-DD HH:MM:SS STATE [BRIGHTNESS]"
+                                    check the mode (clock, sleep, sunrise or setup)
+                                    and the ramp brightness when the wall clock
+                                    reaches that time, may be repeated.  STATE
+                                    repaint instead checks the screen was cleared
+                                    for a full redraw since the previous expectation
+        --expect-boot US            check setup() has the first LED frame out within
+                                    US simulated microseconds (bus time included)
+
+    Expectations are checked in the order given, each when the wall clock
+    passes it, so the repeated hour of a fall-back day can be told apart.  The
+    brightness is the one the mode asks for, before any fade.  The exit status
+    is 1 if any expectation failed or was never reached.
+
+    Telemetry can be watched live:
+        ./sunrise_sim --serial --send T --step 100 | tools/telemetry_viewer.py -
+*/
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "FastLED.h"
+#include "RTClib.h"
+#include "SPI.h"
+#include "../arduino_sunrise.ino"
+
+#define SIM_BUTTON_STEP 10 // Simulated ms per button read while a button is held
+#define SIM_PRESSES 32
+#define SIM_EXPECTS 32
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+CFastLED FastLED;
+SPIClass SPI;
+
+uint64_t sim_ms = 0;       // simulated time since boot
+uint32_t sim_rtc_base = 0; // RTC time at sim_ms == 0
+uint64_t sim_bus_us = 0;   // I2C, EEPROM, SPI and strip transfers so far
+
+struct SimPress
+{
+    byte pin;
+    uint16_t minute_of_day; // wall time to press at
+    unsigned long hold_ms;
+    bool done;
+};
+
+SimPress sim_presses[SIM_PRESSES];
+byte sim_press_count = 0;
+byte sim_held_pin = 0xFF;
+uint64_t sim_release_ms = 0;
+
+struct SimExpect
+{
+    uint32_t wall;    // wall unixtime to check at
+    char state[8];
+    int brightness;   // -1 to skip
+};
+
+SimExpect sim_expects[SIM_EXPECTS];
+byte sim_expect_count = 0;
+byte sim_expect_next = 0;   // first expectation not yet checked
+byte sim_expect_failed = 0;
+unsigned long sim_expect_clears = 0; // tft.clears at the previous expectation
+uint32_t sim_last_wall = 0; // wall unixtime of the previous loop
+
+/* Arduino core
+    The host shims charge their bus transfers (hostBusTime()) at the Pro
+    Mini's rates, e.g. 3.3ms per EEPROM cell written.  Only micros() sees
+    that time, so it measures what the board would spend while millis() and
+    the RTC stay on the --step grid the scenarios are written against.
+*/
+unsigned long millis()
+{
+    return sim_ms;
+}
+
+unsigned long micros()
+{
+    return sim_ms * 1000 + sim_bus_us;
+}
+
+void hostBusTime(unsigned long us)
+{
+    sim_bus_us += us;
+}
+
+void delay(unsigned long ms)
+{
+    sim_ms += ms;
+}
+
+// The sketch polls a held button in a busy loop, so time moves on every read
+int digitalRead(uint8_t pin)
+{
+    if ((pin != sim_held_pin) || (sim_ms >= sim_release_ms))
+    {
+        return HIGH;
+    }
+
+    sim_ms += SIM_BUTTON_STEP;
+    return LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+/* DS1307
+*/
+uint32_t hostRtcTime()
+{
+    return sim_rtc_base + sim_ms / 1000;
+}
+
+void hostRtcAdjust(uint32_t t)
+{
+    sim_rtc_base = t - sim_ms / 1000;
+}
+
+bool hostRtcRunning()
+{
+    return true;
+}
+
+/* Simulator
+*/
+byte simButtonPin(const char *name)
+{
+    if (strcmp(name, "ok") == 0)
+    {
+        return BTN_OK;
+    }
+    if (strcmp(name, "left") == 0)
+    {
+        return BTN_LEFT;
+    }
+    if (strcmp(name, "right") == 0)
+    {
+        return BTN_RIGHT;
+    }
+
+    fprintf(stderr, "unknown button %s\n", name);
+    exit(1);
+}
+
+// BUTTON@HH:MM[:S]
+void simAddPress(const char *spec)
+{
+    char name[8];
+    int hour = 0;
+    int minute = 0;
+    float seconds = 0.2;
+    if (sscanf(spec, "%7[a-z]@%d:%d:%f", name, &hour, &minute, &seconds) < 3)
+    {
+        fprintf(stderr, "bad --press %s\n", spec);
+        exit(1);
+    }
+
+    if (sim_press_count == SIM_PRESSES)
+    {
+        fprintf(stderr, "too many --press\n");
+        exit(1);
+    }
+
+    SimPress press = {simButtonPin(name), (uint16_t)(hour * 60 + minute), (unsigned long)(seconds * 1000), false};
+    sim_presses[sim_press_count++] = press;
+}
+
+// Start any press that is due, one button at a time
+void simPressButtons()
+{
+    if (sim_ms < sim_release_ms)
+    {
+        return;
+    }
+
+    uint16_t minute_of_day = now_now.hour() * 60 + now_now.minute();
+    for (byte i = 0; i < sim_press_count; i++)
+    {
+        if (!sim_presses[i].done && (sim_presses[i].minute_of_day == minute_of_day))
+        {
+            sim_presses[i].done = true;
+            sim_held_pin = sim_presses[i].pin;
+            sim_release_ms = sim_ms + sim_presses[i].hold_ms;
+            return;
+        }
+    }
+}
+
+// "YYYY-MM-DD HH:MM:SS STATE [BRIGHTNESS]"
+void simAddExpect(const char *spec)
+{
+    int year, month, day, hour, minute, second;
+    SimExpect expect;
+    expect.brightness = -1;
+    if (sscanf(spec, "%d-%d-%d %d:%d:%d %7s %d", &year, &month, &day, &hour, &minute, &second,
+               expect.state, &expect.brightness) < 7)
+    {
+        fprintf(stderr, "bad --expect %s\n", spec);
+        exit(1);
+    }
+
+    if (sim_expect_count == SIM_EXPECTS)
+    {
+        fprintf(stderr, "too many --expect\n");
+        exit(1);
+    }
+
+    expect.wall = DateTime(year, month, day, hour, minute, second).unixtime();
+    sim_expects[sim_expect_count++] = expect;
+}
+
+const char *simState()
+{
+    if (setup_mode)
+    {
+        return "setup";
+    }
+    if (sleep_mode)
+    {
+        return "sleep";
+    }
+    return sunrise_mode ? "sunrise" : "clock";
+}
+
+// Check the next expectation once the wall clock has passed it
+void simCheckExpects()
+{
+    uint32_t wall = now_now.unixtime();
+
+    while ((sim_expect_next < sim_expect_count) && (sim_last_wall < sim_expects[sim_expect_next].wall) &&
+           (wall >= sim_expects[sim_expect_next].wall))
+    {
+        SimExpect &expect = sim_expects[sim_expect_next++];
+        bool repainted = (tft.clears != sim_expect_clears);
+        sim_expect_clears = tft.clears;
+
+        const char *state = simState();
+        if (strcmp(expect.state, "repaint") == 0)
+        {
+            state = repainted ? "repaint" : "stale";
+        }
+        bool ok = (strcmp(expect.state, state) == 0) &&
+                  ((expect.brightness < 0) || (expect.brightness == led_target.brightness));
+
+        DateTime at(expect.wall);
+        fprintf(stderr, "%s %04d-%02d-%02d %02d:%02d:%02d  expected %s", ok ? "ok  " : "FAIL",
+                at.year(), at.month(), at.day(), at.hour(), at.minute(), at.second(), expect.state);
+        if (expect.brightness >= 0)
+        {
+            fprintf(stderr, " %d", expect.brightness);
+        }
+        fprintf(stderr, ", got %s %d\n", state, led_target.brightness);
+
+        if (!ok)
+        {
+            sim_expect_failed++;
+        }
+    }
+    sim_last_wall = wall;
+}
+
+void simTrace()
+{
+    static int last_brightness = -1;
+    static byte last_modes = 0xFF;
+    byte modes = setup_mode | (sleep_mode << 1) | (sunrise_mode << 2) | (display_idle << 3);
+
+    if ((led_shown.brightness == last_brightness) && (modes == last_modes))
+    {
+        return;
+    }
+    last_brightness = led_shown.brightness;
+    last_modes = modes;
+
+    fprintf(stderr, "%04d-%02d-%02d %02d:%02d:%02d  bright %3d  rgb %3d %3d %3d %s%s%s%s\n",
+            now_now.year(), now_now.month(), now_now.day(),
+            now_now.hour(), now_now.minute(), now_now.second(),
+            led_shown.brightness, leds[0].r, leds[0].g, leds[0].b,
+            setup_mode ? " setup" : "", sleep_mode ? " sleep" : "",
+            sunrise_mode ? " sunrise" : "", display_idle ? " idle" : "");
+}
+
+int main(int argc, char **argv)
+{
+    DateTime start = DateTime(2019, 10, 30, 5, 0, 0);
+    int alarm_hour = -1;
+    int alarm_minute = 0;
+    int solar_offset = -1000; // solar mode left as stored
+    unsigned long minutes = MINUTES_PER_DAY;
+    unsigned long step = 1000;
+    const char *eeprom_file = NULL;
+    bool tft_profile = false;
+    long boot_us = -1;
+
+    memset(EEPROM.image, 0xFF, sizeof(EEPROM.image));
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : "";
+
+        if (strcmp(arg, "--serial") == 0)
+        {
+            Serial.echo = true;
+            continue;
+        }
+        if (strcmp(arg, "--tft-profile") == 0)
+        {
+            tft_profile = true;
+            continue;
+        }
+
+        i++;
+        if (strcmp(arg, "--start") == 0)
+        {
+            int year, month, day, hour, minute;
+            if (sscanf(value, "%d-%d-%d %d:%d", &year, &month, &day, &hour, &minute) != 5)
+            {
+                fprintf(stderr, "bad --start %s\n", value);
+                return 1;
+            }
+            start = DateTime(year, month, day, hour, minute, 0);
+        }
+        else if (strcmp(arg, "--alarm") == 0)
+        {
+            sscanf(value, "%d:%d", &alarm_hour, &alarm_minute);
+        }
+        else if (strcmp(arg, "--solar") == 0)
+        {
+            solar_offset = atoi(value);
+        }
+        else if (strcmp(arg, "--minutes") == 0)
+        {
+            minutes = strtoul(value, NULL, 10);
+        }
+        else if (strcmp(arg, "--step") == 0)
+        {
+            step = strtoul(value, NULL, 10);
+        }
+        else if (strcmp(arg, "--press") == 0)
+        {
+            simAddPress(value);
+        }
+        else if (strcmp(arg, "--send") == 0)
+        {
+            Serial.input += value;
+        }
+        else if (strcmp(arg, "--send-file") == 0)
+        {
+            FILE *input = fopen(value, "rb");
+            if (input == NULL)
+            {
+                fprintf(stderr, "can't read %s\n", value);
+                return 1;
+            }
+            for (int c; (c = fgetc(input)) != EOF;)
+            {
+                Serial.input += (char)c;
+            }
+            fclose(input);
+        }
+        else if (strcmp(arg, "--expect") == 0)
+        {
+            simAddExpect(value);
+        }
+        else if (strcmp(arg, "--eeprom") == 0)
+        {
+            eeprom_file = value;
+        }
+        else if (strcmp(arg, "--expect-boot") == 0)
+        {
+            boot_us = atol(value);
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", arg);
+            return 1;
+        }
+    }
+
+    if (eeprom_file != NULL)
+    {
+        FILE *image = fopen(eeprom_file, "rb");
+        if (image != NULL)
+        {
+            fread(EEPROM.image, 1, sizeof(EEPROM.image), image);
+            fclose(image);
+        }
+    }
+    if (alarm_hour >= 0)
+    {
+        for (byte i = 0; i < 7; i++)
+        {
+            EEPROM.write(i, alarm_hour);
+            setSunriseMin(i, alarm_minute);
+        }
+    }
+
+    if (solar_offset != -1000)
+    {
+        EEPROM.write(EEPROM_SOLAR_MODE, 1);
+        EEPROM.write(EEPROM_SOLAR_OFFSET, (int8_t)solar_offset);
+    }
+
+    sim_rtc_base = start.unixtime();
+    sim_bus_us = 0; // the settings above are not the sketch's writes
+    setup();
+    sim_last_wall = now_now.unixtime();
+
+    if (boot_us >= 0)
+    {
+        bool ok = (FastLED.shows > 0) && (FastLED.first_show_us <= (unsigned long)boot_us);
+        fprintf(stderr, "%s boot  expected the first LED frame within %ldus, got %luus\n",
+                ok ? "ok  " : "FAIL", boot_us, FastLED.first_show_us);
+        if (!ok)
+        {
+            sim_expect_failed++;
+        }
+    }
+
+    if (tft_profile)
+    {
+#ifdef TFT_PROFILE
+        Serial.echo = true;
+        return (tftProfileSweep() > 0) ? 1 : 0;
+#else
+        fprintf(stderr, "--tft-profile needs a build with -DTFT_PROFILE\n");
+        return 1;
+#endif
+    }
+
+    uint64_t end_ms = sim_ms + minutes * 60000ULL;
+    while (sim_ms < end_ms)
+    {
+        simPressButtons();
+        loop();
+        simTrace();
+        simCheckExpects();
+        sim_ms += step;
+    }
+
+    fprintf(stderr, "%lu LED frames, %lu EEPROM cell writes\n", FastLED.shows, EEPROM.writes);
+
+    if (eeprom_file != NULL)
+    {
+        FILE *image = fopen(eeprom_file, "wb");
+        if (image != NULL)
+        {
+            fwrite(EEPROM.image, 1, sizeof(EEPROM.image), image);
+            fclose(image);
+        }
+    }
+
+    for (byte i = sim_expect_next; i < sim_expect_count; i++)
+    {
+        DateTime at(sim_expects[i].wall);
+        fprintf(stderr, "FAIL %04d-%02d-%02d %02d:%02d:%02d  never reached\n",
+                at.year(), at.month(), at.day(), at.hour(), at.minute(), at.second());
+        sim_expect_failed++;
+    }
+    return (sim_expect_failed > 0) ? 1 : 0;
+}
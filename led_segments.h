@@ -0,0 +1,71 @@
+/* LED segments
+    The strip can be cut into LED_SEGMENTS pieces (1 - 4), each fed from its
+    own data pin, so a frame is sent as several short bursts instead of one
+    long one.  On the Pro Mini the bursts go out one after the other and
+    interrupts are serviced between them, which shortens the longest stretch
+    with interrupts off (~30us per LED); the ESP32 sends them in parallel.
+    tools/led_timing.py prints the numbers for each split.
+
+    leds[] stays one logical strip.  Segment i covers an equal, contiguous
+    share of it (the last one takes any remainder) and is wired from its
+    first LED, unless its bit is set in LED_SEGMENT_REVERSED:  then its data
+    pin is at the far end, as when a strip is fed from the middle outwards.
+    Reversed segments are flipped in place just for the show() and flipped
+    back afterwards, so nothing else needs to know about the wiring.
+*/
+#define LED_SEGMENT_LEDS (NUM_LEDS / LED_SEGMENTS)
+
+// First LED of segment i in leds[]
+uint16_t ledSegmentFirst(byte segment)
+{
+    return segment * LED_SEGMENT_LEDS;
+}
+
+uint16_t ledSegmentCount(byte segment)
+{
+    return (segment == LED_SEGMENTS - 1) ? (NUM_LEDS - ledSegmentFirst(segment)) : LED_SEGMENT_LEDS;
+}
+
+void ledSegmentsBegin()
+{
+    halLedBegin(leds, NUM_LEDS);
+    halLedSegment<DATA_PIN>(ledSegmentFirst(0), ledSegmentCount(0));
+#if LED_SEGMENTS > 1
+    halLedSegment<DATA_PIN_2>(ledSegmentFirst(1), ledSegmentCount(1));
+#endif
+#if LED_SEGMENTS > 2
+    halLedSegment<DATA_PIN_3>(ledSegmentFirst(2), ledSegmentCount(2));
+#endif
+#if LED_SEGMENTS > 3
+    halLedSegment<DATA_PIN_4>(ledSegmentFirst(3), ledSegmentCount(3));
+#endif
+}
+
+// Swap the reversed segments end for end, run twice to undo
+void ledSegmentsFlip()
+{
+    for (byte i = 0; i < LED_SEGMENTS; i++)
+    {
+        if (!(LED_SEGMENT_REVERSED & (1 << i)))
+        {
+            continue;
+        }
+
+        CRGB *first = leds + ledSegmentFirst(i);
+        CRGB *last = first + ledSegmentCount(i) - 1;
+        while (first < last)
+        {
+            CRGB swap = *first;
+            *first++ = *last;
+            *last-- = swap;
+        }
+    }
+}
+
+// Push leds[] to every segment in its wired order
+void ledsShow(byte brightness)
+{
+    ledSegmentsFlip();
+    halLedShow(leds, NUM_LEDS, brightness);
+    ledSegmentsFlip();
+}
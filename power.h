@@ -0,0 +1,87 @@
+/* Power limiter
+    Keeps the strip's estimated current under POWER_BUDGET_MA.  Every frame
+    the channel values in leds[] are summed once (integer adds, ~0.1ms for 150
+    LEDs on the Pro Mini) and weighted by the current each channel draws at
+    full scale, giving the frame's draw at brightness 255.  From that the
+    highest brightness that fits the budget follows with one division.
+
+    The cap drops at once when a frame would go over budget and climbs back
+    one brightness step per POWER_RELEASE_MS, so a frame that briefly needs
+    the limit does not make the strip pump.  power_peak_ma holds the highest
+    estimate pushed to the strip since telemetry last read it.
+*/
+#define POWER_BUDGET_MA 8000 // Strip budget on the 10A brick, leaves room for the board and screen
+#define POWER_MA_RED 20      // Draw of one channel at full scale (WS2812B datasheet)
+#define POWER_MA_GREEN 20
+#define POWER_MA_BLUE 20
+#define POWER_MA_IDLE 1      // Draw of one dark LED
+#define POWER_RELEASE_MS 20  // Cap recovery, one brightness step per period (~5s from 0 to 255)
+
+byte power_cap = 255;              // brightness limit currently applied
+unsigned long power_release = 0;   // millis() of the last cap step up
+uint16_t power_ma = 0;             // estimate for the last frame shown
+uint16_t power_peak_ma = 0;        // highest estimate since the last telemetry frame
+
+// The channel sums are 16 bit to keep the inner loop in 16 bit adds on AVR,
+// longer strips need uint32_t sums
+static_assert(NUM_LEDS * 255UL <= 0xFFFF, "power channel sums overflow above 257 LEDs");
+
+// Estimated draw at brightness 255, without the idle current (count at most NUM_LEDS)
+uint32_t powerFullScaleMa(CRGB *pixels, uint16_t count)
+{
+    uint16_t red = 0;
+    uint16_t green = 0;
+    uint16_t blue = 0;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        red += pixels[i].r;
+        green += pixels[i].g;
+        blue += pixels[i].b;
+    }
+
+    return ((uint32_t)red * POWER_MA_RED + (uint32_t)green * POWER_MA_GREEN + (uint32_t)blue * POWER_MA_BLUE) / 255;
+}
+
+// Brightness to show the frame at, at most the one asked for
+byte powerLimit(CRGB *pixels, uint16_t count, byte brightness)
+{
+    uint32_t full_scale = powerFullScaleMa(pixels, count);
+    uint32_t idle = (uint32_t)count * POWER_MA_IDLE;
+
+    // Highest brightness that fits, FastLED scales channels by (brightness + 1) / 256
+    uint16_t fits = 255;
+    if ((full_scale + idle) > POWER_BUDGET_MA)
+    {
+        fits = ((POWER_BUDGET_MA - idle) * 256) / full_scale;
+        fits = (fits > 0) ? fits - 1 : 0;
+    }
+
+    if (fits <= power_cap)
+    {
+        power_cap = fits;
+        power_release = millis();
+    }
+    else if ((power_cap < fits) && ((millis() - power_release) >= POWER_RELEASE_MS))
+    {
+        uint16_t steps = (millis() - power_release) / POWER_RELEASE_MS;
+        power_cap = min(fits, (uint16_t)(power_cap + steps));
+        power_release += steps * POWER_RELEASE_MS;
+    }
+
+    if (brightness > power_cap)
+    {
+        brightness = power_cap;
+    }
+
+    power_ma = idle;
+    if (brightness > 0)
+    {
+        power_ma += (full_scale * (brightness + 1)) / 256;
+    }
+    if (power_ma > power_peak_ma)
+    {
+        power_peak_ma = power_ma;
+    }
+    return brightness;
+}
@@ -0,0 +1,50 @@
+/* Solar mode
+    Anchors every day's sunrise to the real sunrise from solar_table.h (plus
+    a configurable offset) instead of the stored alarm times.  The table is
+    generated on a PC by tools/solar_table.py, so the lookup is one PROGMEM
+    read per day with no floating point on the board.
+*/
+#include "./solar_table.h"
+
+#define SOLAR_OFFSET_STEP 5  // Offset adjustment per button press (minutes)
+#define SOLAR_OFFSET_MAX 120 // Largest offset either side of sunrise (minutes)
+
+// First day of each month in the table's leap year layout
+const uint16_t solar_month_start[12] PROGMEM = {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
+
+bool solarEnabled()
+{
+    return readEByte(EEPROM_SOLAR_MODE) == 1;
+}
+
+// Minutes between the real sunrise and the start of the LED sunrise
+int solarOffset()
+{
+    int value = (int8_t)readEByte(EEPROM_SOLAR_OFFSET);
+
+    return constrain(value, -SOLAR_OFFSET_MAX, SOLAR_OFFSET_MAX);
+}
+
+// Sunrise for the date in minutes after local standard midnight, -1 if the sun does not rise
+int solarSunrise(const DateTime &date)
+{
+    uint16_t index = pgm_read_word(&solar_month_start[date.month() - 1]) + date.day() - 1;
+    uint16_t utc = pgm_read_word(&solar_sunrise[index]);
+
+    if (utc == SOLAR_NO_SUNRISE)
+    {
+        return -1;
+    }
+
+    int local = (int)utc + SOLAR_UTC_OFFSET;
+    if (local < 0)
+    {
+        local += MINUTES_PER_DAY;
+    }
+    else if (local >= MINUTES_PER_DAY)
+    {
+        local -= MINUTES_PER_DAY;
+    }
+
+    return local;
+}
@@ -0,0 +1,43 @@
+/* Solar sunrise table
+    Generated by tools/solar_table.py --lat 42.36 --lon -71.06 --utc-offset -5
+    Sunrise in minutes after UTC midnight for each day of a leap year
+    (Jan 1 = 0, Feb 29 = 59), SOLAR_NO_SUNRISE where the sun does not rise.
+*/
+#define SOLAR_LATITUDE 42.36
+#define SOLAR_LONGITUDE -71.06
+#define SOLAR_UTC_OFFSET -300 // Local standard time (minutes)
+#define SOLAR_NO_SUNRISE 0xFFFF
+
+const uint16_t solar_sunrise[366] PROGMEM = {
+    733, 734, 734, 734, 734, 733, 733, 733, 733, 733, 732, 732,
+    732, 731, 731, 730, 730, 729, 729, 728, 728, 727, 726, 725,
+    725, 724, 723, 722, 721, 720, 719, 718, 717, 716, 715, 714,
+    713, 711, 710, 709, 708, 706, 705, 704, 702, 701, 700, 698,
+    697, 695, 694, 692, 691, 689, 688, 686, 685, 683, 682, 680,
+    678, 677, 675, 673, 672, 670, 668, 667, 665, 663, 662, 660,
+    658, 657, 655, 653, 651, 650, 648, 646, 644, 643, 641, 639,
+    637, 636, 634, 632, 631, 629, 627, 625, 624, 622, 620, 619,
+    617, 615, 613, 612, 610, 608, 607, 605, 604, 602, 600, 599,
+    597, 596, 594, 593, 591, 590, 588, 587, 585, 584, 582, 581,
+    580, 578, 577, 576, 574, 573, 572, 571, 570, 568, 567, 566,
+    565, 564, 563, 562, 561, 560, 559, 558, 557, 557, 556, 555,
+    554, 554, 553, 552, 552, 551, 551, 550, 550, 549, 549, 548,
+    548, 548, 548, 547, 547, 547, 547, 547, 547, 547, 547, 547,
+    547, 547, 547, 547, 548, 548, 548, 549, 549, 549, 550, 550,
+    551, 551, 552, 552, 553, 553, 554, 555, 555, 556, 557, 558,
+    558, 559, 560, 561, 562, 562, 563, 564, 565, 566, 567, 568,
+    569, 570, 571, 572, 573, 574, 575, 576, 577, 578, 579, 580,
+    581, 582, 583, 584, 585, 586, 587, 588, 589, 590, 591, 592,
+    593, 594, 595, 597, 598, 599, 600, 601, 602, 603, 604, 605,
+    606, 607, 608, 609, 610, 611, 612, 613, 615, 616, 617, 618,
+    619, 620, 621, 622, 623, 624, 625, 626, 627, 628, 629, 630,
+    631, 632, 634, 635, 636, 637, 638, 639, 640, 641, 642, 643,
+    644, 646, 647, 648, 649, 650, 651, 652, 653, 655, 656, 657,
+    658, 659, 660, 661, 663, 664, 665, 666, 667, 669, 670, 671,
+    672, 674, 675, 676, 677, 678, 680, 681, 682, 683, 685, 686,
+    687, 688, 690, 691, 692, 693, 695, 696, 697, 698, 700, 701,
+    702, 703, 704, 706, 707, 708, 709, 710, 711, 712, 713, 715,
+    716, 717, 718, 719, 720, 720, 721, 722, 723, 724, 725, 726,
+    726, 727, 728, 728, 729, 729, 730, 730, 731, 731, 732, 732,
+    732, 733, 733, 733, 733, 733,
+};
@@ -0,0 +1,117 @@
+/* Telemetry
+    Serial command 'T' toggles a binary stream of the LED frame, brightness and
+    mode flags for tools/telemetry_viewer.py.  Frames are written straight from
+    leds[] without a copy, and only as many bytes as fit in the serial transmit
+    buffer go out per loop, so streaming never blocks the loop.  The LEDs can
+    change while a frame is being sent; the viewer simply shows what was sent.
+
+    Frame layout (little endian):
+        0xA5 0x5A             sync
+        length (uint16)       bytes from brightness up to the checksum
+        brightness            global LED brightness
+        flags                 TELEMETRY_* mode bits
+        millis (uint32)       time the frame was started
+        timeline_us (uint16)  time spent layering LED timelines for the last frame
+        peak_ma (uint16)      highest estimated strip current since the previous frame
+        leds (NUM_LEDS * 3)   r, g, b
+        checksum              8 bit sum of everything after the length
+*/
+#define TELEMETRY_INTERVAL 100 // Milliseconds between frame starts (a frame takes ~10ms at 500000 baud)
+#define TELEMETRY_SYNC_1 0xA5
+#define TELEMETRY_SYNC_2 0x5A
+#define TELEMETRY_HEADER 14
+#define TELEMETRY_FRAME (TELEMETRY_HEADER + NUM_LEDS * 3 + 1)
+
+// Mode flags
+#define TELEMETRY_SETUP 0x01
+#define TELEMETRY_SLEEP 0x02
+#define TELEMETRY_SUNRISE 0x04
+#define TELEMETRY_IDLE 0x08
+
+bool telemetry_enabled = false;
+uint16_t telemetry_pos = 0;         // bytes of the current frame sent, 0 between frames
+unsigned long telemetry_last = 0;   // millis() the current frame was started
+byte telemetry_header[TELEMETRY_HEADER];
+byte telemetry_sum = 0;
+
+void telemetryStartFrame()
+{
+    uint16_t length = TELEMETRY_FRAME - 4 - 1;
+
+    telemetry_last = millis();
+    telemetry_header[0] = TELEMETRY_SYNC_1;
+    telemetry_header[1] = TELEMETRY_SYNC_2;
+    telemetry_header[2] = lowByte(length);
+    telemetry_header[3] = highByte(length);
+    telemetry_header[4] = led_shown.brightness;
+    telemetry_header[5] = (setup_mode ? TELEMETRY_SETUP : 0) |
+                          (sleep_mode ? TELEMETRY_SLEEP : 0) |
+                          (sunrise_mode ? TELEMETRY_SUNRISE : 0) |
+                          (display_idle ? TELEMETRY_IDLE : 0);
+    memcpy(&telemetry_header[6], &telemetry_last, 4);
+    memcpy(&telemetry_header[10], &timeline_us, 2);
+    memcpy(&telemetry_header[12], &power_peak_ma, 2);
+    power_peak_ma = power_ma;
+    telemetry_sum = 0;
+}
+
+// Send as much of the current frame as the serial buffer takes without blocking,
+// paused while an Adalight sender has the port
+void telemetrySend()
+{
+    if (!telemetry_enabled || adalight_streaming)
+    {
+        return;
+    }
+
+    if (telemetry_pos == 0)
+    {
+        if ((millis() - telemetry_last) < TELEMETRY_INTERVAL)
+        {
+            return;
+        }
+        telemetryStartFrame();
+    }
+
+    int room = Serial.availableForWrite();
+    while ((room > 0) && (telemetry_pos < TELEMETRY_FRAME))
+    {
+        const byte *chunk;
+        uint16_t count;
+
+        if (telemetry_pos < TELEMETRY_HEADER)
+        {
+            chunk = &telemetry_header[telemetry_pos];
+            count = TELEMETRY_HEADER - telemetry_pos;
+        }
+        else if (telemetry_pos < (TELEMETRY_FRAME - 1))
+        {
+            chunk = (const byte *)leds + (telemetry_pos - TELEMETRY_HEADER);
+            count = TELEMETRY_FRAME - 1 - telemetry_pos;
+        }
+        else
+        {
+            chunk = &telemetry_sum;
+            count = 1;
+        }
+        count = min(count, (uint16_t)room);
+
+        // The sync and length bytes are not part of the checksum
+        for (uint16_t i = 0; i < count; i++)
+        {
+            if ((telemetry_pos + i) >= 4 && (telemetry_pos + i) < (TELEMETRY_FRAME - 1))
+            {
+                telemetry_sum += chunk[i];
+            }
+        }
+
+        Serial.write(chunk, count);
+        telemetry_pos += count;
+        room -= count;
+    }
+
+    if (telemetry_pos == TELEMETRY_FRAME)
+    {
+        telemetry_pos = 0;
+    }
+}
@@ -0,0 +1,89 @@
+/* TFT traffic profiling
+    Build with TFT_PROFILE defined to replace tft with a TFT subclass that
+    counts what reaches the ST7735: every primitive the GFX code bottoms out in
+    sets one address window (CASET, RASET, RAMWR) and then pushes its pixels,
+    and the bare commands from tftCommand() are counted on their way to
+    halTftCommand().  Serial command 'P'
+    (tftProfileSweep()) draws each screen element in every mode and prints the
+    traffic next to its budget, with the on-wire time estimated at the Pro
+    Mini's SPI clock.
+
+    The budgets are the worst mode measured by the host sweep
+    (sunrise_sim --tft-profile, run by host/run_tests.sh) plus ~20% for other
+    digits and strings.  The host TFT rasterises text and rects the way the
+    library does, so it counts the same traffic as the board.  Re-measure
+    when the layout changes; an element reported as OVER draws more than it
+    used to and fails the host tests.
+*/
+#ifdef TFT_PROFILE
+
+#define TFT_SPI_MHZ 4       // Hardware SPI with SPI_CLOCK_DIV4 on a 16MHz board
+#define TFT_WINDOW_BYTES 11 // CASET + 4 data, RASET + 4 data, RAMWR
+#define TFT_WINDOW_COMMANDS 3
+#define TFT_PIXEL_BYTES 2   // RGB565
+
+// Budgets (estimated on-wire microseconds, worst mode)
+#define TFT_BUDGET_INFO 900
+#define TFT_BUDGET_HOUR 3200
+#define TFT_BUDGET_MINUTE 4900
+#define TFT_BUDGET_SECOND 4900
+#define TFT_BUDGET_AMPM 3100
+#define TFT_BUDGET_YEAR 2800
+#define TFT_BUDGET_MONTH 900
+#define TFT_BUDGET_DAY 1300
+#define TFT_BUDGET_DOW 3700
+#define TFT_BUDGET_NEXT_SUNRISE 17500
+#define TFT_BUDGET_CURRENT_MODE 17100
+#define TFT_BUDGET_IDLE_MODE 10
+
+uint16_t tft_windows = 0; // address windows set since the last reset
+uint32_t tft_pixels = 0;  // pixels pushed since the last reset
+uint16_t tft_commands = 0; // controller commands since the last reset:  per window and bare ones (tftCommand())
+
+class MeteredTFT : public TFT
+{
+public:
+    MeteredTFT(uint8_t cs, uint8_t dc, uint8_t rst) : TFT(cs, dc, rst) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color)
+    {
+        meter(1);
+        TFT::drawPixel(x, y, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+        meter(h);
+        TFT::drawFastVLine(x, y, h, color);
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+        meter(w);
+        TFT::drawFastHLine(x, y, w, color);
+    }
+
+    // fillScreen() is routed through fillRect() by the driver
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+        meter((uint32_t)w * h);
+        TFT::fillRect(x, y, w, h, color);
+    }
+
+private:
+    void meter(uint32_t pixels)
+    {
+        tft_windows++;
+        tft_commands += TFT_WINDOW_COMMANDS;
+        tft_pixels += pixels;
+    }
+};
+
+// Estimated time on the wire for the traffic counted so far, a bare command is one byte
+uint32_t tftTrafficMicros()
+{
+    uint32_t bare = tft_commands - (uint32_t)tft_windows * TFT_WINDOW_COMMANDS;
+    return ((uint32_t)tft_windows * TFT_WINDOW_BYTES + bare + tft_pixels * TFT_PIXEL_BYTES) * 8 / TFT_SPI_MHZ;
+}
+
+#endif
@@ -0,0 +1,177 @@
+/* LED timelines
+    Mode changes blend instead of cutting.  Every loop the current mode asks
+    for a target frame (one color and a brightness for the whole strip) and
+    showFrame() layers the running timelines over it before pushing it to the
+    strip.  Each timeline is stepped from millis(), never with delay().
+
+    TL_PULSE loops between two colors (the setup mode flash) and replaces the
+    target's color.  TL_FADE cross-fades from the frame that was showing when
+    it started to whatever the layers below it produce, so a snooze fade-out
+    layered over a running sunrise, or two fades started back to back, compose
+    without either one jumping.  Pulses are applied before fades.
+
+    Every layer costs the same few blend8 steps per frame, however far along it
+    is; the time spent is kept in timeline_us for the telemetry stream.
+*/
+#define TIMELINE_SLOTS 3
+#define TL_NONE 0
+#define TL_PULSE 1 // Loop from -> to -> from, replacing the target color
+#define TL_FADE 2  // Cross-fade from the frame shown at the start to the target
+
+struct LedFrame
+{
+    CRGB color;
+    byte brightness;
+};
+
+struct Timeline
+{
+    byte kind;
+    unsigned long start;   // millis() at the first step
+    uint16_t duration;     // milliseconds for one pass
+    LedFrame from;
+    LedFrame to;           // TL_PULSE only
+};
+
+Timeline timelines[TIMELINE_SLOTS];
+LedFrame led_target = {CRGB::Black, 0}; // frame the current mode asks for
+LedFrame led_shown = {CRGB::Black, 0};  // last frame pushed to the strip
+uint16_t timeline_us = 0;              // time spent layering the last frame
+
+bool timelineRunning(byte kind)
+{
+    for (byte i = 0; i < TIMELINE_SLOTS; i++)
+    {
+        if (timelines[i].kind == kind)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void timelineStop(byte kind)
+{
+    for (byte i = 0; i < TIMELINE_SLOTS; i++)
+    {
+        if (timelines[i].kind == kind)
+        {
+            timelines[i].kind = TL_NONE;
+        }
+    }
+}
+
+// Claim a free slot (the oldest fade if all are busy)
+Timeline *timelineStart(byte kind, uint16_t duration)
+{
+    Timeline *slot = NULL;
+
+    for (byte i = 0; i < TIMELINE_SLOTS; i++)
+    {
+        if (timelines[i].kind == TL_NONE)
+        {
+            slot = &timelines[i];
+            break;
+        }
+        if ((timelines[i].kind == TL_FADE) && ((slot == NULL) || (timelines[i].start < slot->start)))
+        {
+            slot = &timelines[i];
+        }
+    }
+
+    if (slot != NULL)
+    {
+        slot->kind = kind;
+        slot->start = millis();
+        slot->duration = duration;
+        slot->from = led_shown;
+    }
+
+    return slot;
+}
+
+// Cross-fade from what is showing now to whatever the modes ask for
+void timelineFade(uint16_t duration)
+{
+    timelineStart(TL_FADE, duration);
+}
+
+// Flash between two colors, one full cycle per period
+void timelinePulse(CRGB from, CRGB to, uint16_t period)
+{
+    Timeline *slot = timelineStart(TL_PULSE, period);
+    if (slot != NULL)
+    {
+        slot->from.color = from;
+        slot->to.color = to;
+    }
+}
+
+// Position within the current pass, 0 - 255 (256 once a fade has finished)
+uint16_t timelineProgress(Timeline &timeline)
+{
+    unsigned long elapsed = millis() - timeline.start;
+
+    if (timeline.kind == TL_PULSE)
+    {
+        elapsed %= timeline.duration;
+    }
+    else if (elapsed >= timeline.duration)
+    {
+        return 256;
+    }
+
+    return (elapsed * 256) / timeline.duration;
+}
+
+// Layer every running timeline over the target frame
+void timelineApply(LedFrame &frame)
+{
+    for (byte kind = TL_PULSE; kind <= TL_FADE; kind++)
+    {
+        for (byte i = 0; i < TIMELINE_SLOTS; i++)
+        {
+            Timeline &timeline = timelines[i];
+            if (timeline.kind != kind)
+            {
+                continue;
+            }
+
+            uint16_t progress = timelineProgress(timeline);
+            if (progress > 255)
+            {
+                // Finished, the target shows through from now on
+                timeline.kind = TL_NONE;
+                continue;
+            }
+
+            if (kind == TL_PULSE)
+            {
+                // Triangle wave, eased at both ends
+                byte level = (progress < 128) ? progress * 2 : (255 - progress) * 2;
+                frame.color = blend(timeline.from.color, timeline.to.color, ease8InOutQuad(level));
+            }
+            else
+            {
+                byte amount = ease8InOutQuad(progress);
+                frame.color = blend(timeline.from.color, frame.color, amount);
+                frame.brightness = lerp8by8(timeline.from.brightness, frame.brightness, amount);
+            }
+        }
+    }
+}
+
+// Layer the timelines over the target frame and push the result to the strip,
+// dimmed if needed to stay within the power budget
+void showFrame(LedFrame frame)
+{
+    unsigned long started = micros();
+    timelineApply(frame);
+    timeline_us = micros() - started;
+
+    fill_solid(leds, NUM_LEDS, frame.color);
+    frame.brightness = powerLimit(leds, NUM_LEDS, frame.brightness);
+    ledsShow(frame.brightness);
+    led_shown = frame;
+}
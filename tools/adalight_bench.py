@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Stream Adalight frames to the sunrise clock and report frames/s and drops.
+
+Sends a moving rainbow for a while and counts the ACK the sketch writes after
+every frame it shows, and the NAK after every frame it drops (see adalight.h):
+
+    tools/adalight_bench.py /dev/ttyUSB0
+    tools/adalight_bench.py /dev/ttyUSB0 --seconds 30
+    tools/adalight_bench.py /dev/ttyUSB0 --blind --fps 60
+
+By default each frame waits for the previous one's ACK or NAK (--ack-timeout
+ms at most, a timeout counts as a drop).  --blind sends at a fixed rate
+without waiting, as plain Adalight senders do; drops are then the frames sent
+that were never ACKed.  The sketch's baud rate is SERIAL_BAUD in
+arduino_sunrise.h.  Needs pyserial.
+"""
+import argparse
+import colorsys
+import time
+
+ACK = 0x06
+NAK = 0x15
+
+
+def frame(leds, offset):
+    """Header plus a rainbow shifted by offset LEDs."""
+    hi, lo = (leds - 1) >> 8, (leds - 1) & 0xFF
+    data = bytearray(b"Ada" + bytes((hi, lo, hi ^ lo ^ 0x55)))
+    for i in range(leds):
+        r, g, b = colorsys.hsv_to_rgb(((i + offset) % leds) / float(leds), 1.0, 0.5)
+        data += bytes((int(r * 255), int(g * 255), int(b * 255)))
+    return bytes(data)
+
+
+def wire_fps(leds, baud):
+    """Frame rate the serial line alone allows, 10 bits per byte."""
+    return baud / (10.0 * (6 + 3 * leds))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=500000)
+    parser.add_argument("--leds", type=int, default=150)
+    parser.add_argument("--seconds", type=float, default=10)
+    parser.add_argument("--ack-timeout", type=float, default=200, help="ms to wait for each ACK")
+    parser.add_argument("--blind", action="store_true", help="send without waiting for ACKs")
+    parser.add_argument("--fps", type=float, default=30, help="send rate with --blind")
+    args = parser.parse_args()
+
+    import serial  # pyserial
+
+    port = serial.Serial(args.port, args.baud, timeout=args.ack_timeout / 1000.0)
+    time.sleep(2)  # the Pro Mini resets when the port opens
+    port.reset_input_buffer()
+
+    # Frames are prepared up front so the sender is never the bottleneck
+    frames = [frame(args.leds, i) for i in range(args.leds)]
+    sent = acked = naks = timeouts = 0
+    started = time.time()
+    while time.time() - started < args.seconds:
+        port.write(frames[sent % len(frames)])
+        sent += 1
+        if args.blind:
+            acked += port.read(port.in_waiting).count(ACK)
+            time.sleep(max(0, sent / args.fps - (time.time() - started)))
+            continue
+        reply = port.read(1)
+        if reply == bytes((ACK,)):
+            acked += 1
+        elif reply == bytes((NAK,)):
+            naks += 1
+        else:
+            timeouts += 1
+
+    elapsed = time.time() - started
+    time.sleep(args.ack_timeout / 1000.0)
+    acked += port.read(port.in_waiting).count(ACK)
+
+    print("%d LEDs at %d baud, %s" % (args.leds, args.baud, "blind" if args.blind else "waiting for ACKs"))
+    print("sent %d frames in %.1fs, %d shown, %d dropped (%d NAKs, %d ACK timeouts)"
+          % (sent, elapsed, acked, sent - acked, naks, timeouts))
+    print("%.1f frames/s shown, the serial line alone allows %.1f"
+          % (acked / elapsed, wire_fps(args.leds, args.baud)))
+
+
+if __name__ == "__main__":
+    main()
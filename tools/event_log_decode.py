@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Decode a sunrise clock event log dump into a timeline.
+
+Capture the dump by sending 'L' over the serial console (SERIAL_BAUD, 500000) and
+saving everything the clock prints, then:
+
+    tools/event_log_decode.py dump.txt
+    tools/event_log_decode.py < dump.txt
+
+Record layout (4 bytes, little endian) matches EventRecord in event_log.h:
+    code | lap bit, payload, delta (uint16):  seconds, or with the top bit
+    set whole minutes in the low 15 bits
+"""
+import argparse
+import datetime
+import struct
+import sys
+
+EMPTY = 0xFF
+LAP = 0x80
+MINUTES = 0x8000
+
+TIME_HI = 1
+TIME_LO = 2
+
+EPOCH = datetime.datetime(1970, 1, 1)
+
+DAYS = ["Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"]
+
+EVENTS = {
+    3: ("boot", lambda p: "RTC reset to compile time" if p else ""),
+    4: ("sunrise start", lambda p: DAYS[p] if p < 7 else str(p)),
+    5: ("sunrise end", lambda p: DAYS[p] if p < 7 else str(p)),
+    6: ("snooze", lambda p: "during sunrise" if p else ""),
+    7: ("setup mode", lambda p: "enter" if p else "leave"),
+    8: ("setting +", lambda p: chr(p)),
+    9: ("setting -", lambda p: chr(p)),
+    10: ("LEDs off", lambda p: ""),
+    11: ("DST", lambda p: "start" if p else "end"),
+    12: ("Adalight stream", lambda p: "start" if p else "timed out"),
+    13: ("snooze over", lambda p: "sunrise resumes" if p else ""),
+}
+
+
+def read_dump(lines):
+    """Return (slots, head, dropped, raw record list) from the dump text."""
+    header = None
+    records = []
+    for line in lines:
+        line = line.strip()
+        if line.startswith("EVTLOG END"):
+            break
+        if line.startswith("EVTLOG"):
+            header = [int(v) for v in line.split()[1:4]]
+            records = []
+            continue
+        if header is not None and len(line) == 8:
+            records.append(bytes.fromhex(line))
+    if header is None:
+        sys.exit("no EVTLOG header found")
+    return header[0], header[1], header[2], records
+
+
+def decode(records, head):
+    """Yield (unixtime or None, code, payload) from oldest to newest."""
+    ordered = records[head:] + records[:head]
+    now = None
+    high = None
+    for raw in ordered:
+        code, payload, delta = struct.unpack("<BBH", raw)
+        if code == EMPTY:
+            continue
+        code &= ~LAP & 0xFF
+        if code == TIME_HI:
+            high = delta
+            continue
+        if code == TIME_LO:
+            if high is not None:
+                now = (high << 16) | delta
+            continue
+        if now is not None:
+            now += (delta & ~MINUTES) * 60 if delta & MINUTES else delta
+        yield now, code, payload
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", nargs="?", type=argparse.FileType("r"), default=sys.stdin)
+    args = parser.parse_args()
+
+    slots, head, dropped, records = read_dump(args.dump)
+    if len(records) != slots:
+        sys.exit("expected %d records, found %d" % (slots, len(records)))
+
+    for when, code, payload in decode(records, head):
+        # The clock keeps local time, so print the stamp without conversion
+        if when is None:
+            stamp = "????-??-?? ??:??:??"
+        else:
+            stamp = (EPOCH + datetime.timedelta(seconds=when)).strftime("%Y-%m-%d %H:%M:%S")
+        name, detail = EVENTS.get(code, ("event %d" % code, lambda p: str(p)))
+        print("%s  %-14s %s" % (stamp, name, detail(payload)))
+
+    if dropped:
+        print("(%d events dropped by a full queue)" % dropped)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Model WS2812B output timing for the strip split into 1 - 4 segments.
+
+For each split prints the longest stretch with interrupts off, the time to
+send one frame, the LED frame rate that leaves, and how many bytes a serial
+burst can lose while interrupts are off:
+
+    tools/led_timing.py
+    tools/led_timing.py --leds 300 --baud 115200 --loop-us 3000
+
+Pro Mini (FastLED with FASTLED_ALLOW_INTERRUPTS 0): segments are sent one
+after the other and interrupts are serviced between them, so only the
+longest segment counts against the interrupts-off window.  ESP32: the RMT
+peripheral sends every segment at once with interrupts on, from the other
+core, so loop() never waits for the strip.
+
+The USART on the ATmega328P holds two received bytes plus the one being
+shifted in; a longer gap overruns it.  Buttons are polled from loop(), so the
+loop period (--loop-us for everything else, plus the LED frame on the Pro
+Mini) is the shortest press that is always seen.
+
+Splitting shortens the window but does not close it on the Pro Mini: a 150
+LED strip in four segments still loses about 57 bytes of a burst per frame
+at the sketch's 500000 baud (11 at 115200).  Serial input has to arrive between frames, as it does for a
+sender that waits for the Adalight ACK (adalight.h).
+"""
+import argparse
+
+BIT_US = 1.25          # WS2812B bit period
+LED_US = 24 * BIT_US   # 24 bits per LED
+SEGMENT_SETUP_US = 10  # FastLED per-controller overhead (approximate)
+UART_BUFFER = 2        # ATmega328P receive FIFO
+
+
+def segments_of(leds, count):
+    """Segment lengths as led_segments.h splits them (the last takes the rest)."""
+    share = leds // count
+    return [share] * (count - 1) + [leds - share * (count - 1)]
+
+
+def model(leds, count, parallel, latch_us, loop_us, baud):
+    lengths = segments_of(leds, count)
+    send = [n * LED_US + SEGMENT_SETUP_US for n in lengths]
+    if parallel:
+        frame_us = max(send) + latch_us
+        masked_us = 0
+        loop_period_us = loop_us
+    else:
+        frame_us = sum(send) + latch_us
+        masked_us = max(send)
+        loop_period_us = frame_us + loop_us
+
+    byte_us = 10 * 1e6 / baud
+    lost = max(0, int(masked_us / byte_us) - UART_BUFFER)
+    return {
+        "lengths": lengths,
+        "masked_us": masked_us,
+        "frame_us": frame_us,
+        "fps": 1e6 / frame_us,
+        "loop_fps": min(1e6 / frame_us, 1e6 / loop_period_us),
+        "press_ms": loop_period_us / 1000.0,
+        "lost": lost,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--leds", type=int, default=150)
+    parser.add_argument("--segments", default="1,2,3,4", help="comma separated splits to model")
+    parser.add_argument("--baud", type=int, default=500000)
+    parser.add_argument("--latch-us", type=float, default=50,
+                        help="reset time between frames (50, or 280 for newer WS2812B)")
+    parser.add_argument("--loop-us", type=float, default=2000,
+                        help="time loop() spends on everything but the LEDs")
+    args = parser.parse_args()
+
+    byte_us = 10 * 1e6 / args.baud
+    print("%d LEDs, %.0fus per LED, serial byte every %.1fus (%d buffered)"
+          % (args.leds, LED_US, byte_us, UART_BUFFER))
+    print("%-6s %-4s %-16s %10s %10s %8s %9s %9s %10s"
+          % ("board", "segs", "lengths", "irq off us", "frame us", "max fps",
+             "loop fps", "press ms", "rx lost"))
+
+    for board, parallel in (("avr", False), ("esp32", True)):
+        for count in (int(c) for c in args.segments.split(",")):
+            if not 1 <= count <= 4:
+                parser.error("segments must be 1 - 4")
+            m = model(args.leds, count, parallel, args.latch_us, args.loop_us, args.baud)
+            print("%-6s %-4d %-16s %10.0f %10.0f %8.0f %9.0f %9.1f %10d"
+                  % (board, count, "/".join(str(n) for n in m["lengths"]), m["masked_us"],
+                     m["frame_us"], m["fps"], m["loop_fps"], m["press_ms"], m["lost"]))
+
+
+if __name__ == "__main__":
+    main()
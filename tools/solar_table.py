@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Generate solar_table.h, the day-of-year sunrise table used by solar mode.
+
+The clock never does trigonometry: this script works out sunrise for every day
+of the year with the NOAA solar position equations and writes it out as a
+PROGMEM table of minutes after UTC midnight, indexed by day of a leap year
+(Jan 1 = 0, Feb 29 = 59, Dec 31 = 365).
+
+    tools/solar_table.py --lat 42.36 --lon -71.06 --utc-offset -5 > solar_table.h
+
+--check compares the table with sunrise times published for the location
+(the U.S. Naval Observatory's rise/set tables, solstices and equinoxes) and
+exits non-zero if any is off by more than CHECK_TOLERANCE minutes.  Only the
+locations in PUBLISHED have reference times.
+"""
+import argparse
+import datetime
+import math
+import sys
+
+NO_SUNRISE = 0xFFFF
+TABLE_YEAR = 2024  # any leap year, the table has a slot for Feb 29
+ZENITH = 90.833    # geometric horizon plus refraction and the solar disc
+
+# Published sunrises in local standard time (daylight time minus an hour),
+# rounded to the minute, for (lat, lon) to within 0.1 degree
+PUBLISHED = {
+    (42.36, -71.06): (  # Boston, MA
+        ("2020-03-20", "05:46"),  # 06:46 EDT
+        ("2020-06-20", "04:07"),  # 05:07 EDT
+        ("2020-09-22", "05:32"),  # 06:32 EDT
+        ("2020-12-21", "07:11"),
+    ),
+}
+# Both sides round to the minute and the table stands for every year
+CHECK_TOLERANCE = 2
+
+
+def sunrise_utc_minutes(date, lat, lon):
+    """Minutes after UTC midnight of sunrise on date, or None if the sun stays up or down."""
+    # Julian century of local noon
+    jd = date.toordinal() + 1721424.5 + 0.5 - lon / 360.0
+    t = (jd - 2451545.0) / 36525.0
+
+    mean_lon = (280.46646 + t * (36000.76983 + t * 0.0003032)) % 360
+    mean_anom = 357.52911 + t * (35999.05029 - 0.0001537 * t)
+    ecc = 0.016708634 - t * (0.000042037 + 0.0000001267 * t)
+    m = math.radians(mean_anom)
+    center = (math.sin(m) * (1.914602 - t * (0.004817 + 0.000014 * t))
+              + math.sin(2 * m) * (0.019993 - 0.000101 * t)
+              + math.sin(3 * m) * 0.000289)
+    true_lon = mean_lon + center
+    omega = 125.04 - 1934.136 * t
+    app_lon = true_lon - 0.00569 - 0.00478 * math.sin(math.radians(omega))
+    obliq = (23 + (26 + (21.448 - t * (46.815 + t * (0.00059 - t * 0.001813))) / 60) / 60
+             + 0.00256 * math.cos(math.radians(omega)))
+    decl = math.asin(math.sin(math.radians(obliq)) * math.sin(math.radians(app_lon)))
+
+    y = math.tan(math.radians(obliq) / 2) ** 2
+    l0 = math.radians(mean_lon)
+    eq_time = 4 * math.degrees(
+        y * math.sin(2 * l0)
+        - 2 * ecc * math.sin(m)
+        + 4 * ecc * y * math.sin(m) * math.cos(2 * l0)
+        - 0.5 * y * y * math.sin(4 * l0)
+        - 1.25 * ecc * ecc * math.sin(2 * m))
+
+    phi = math.radians(lat)
+    cos_ha = (math.cos(math.radians(ZENITH)) / (math.cos(phi) * math.cos(decl))
+              - math.tan(phi) * math.tan(decl))
+    if cos_ha < -1 or cos_ha > 1:
+        return None
+    hour_angle = math.degrees(math.acos(cos_ha))
+
+    noon = 720 - 4 * lon - eq_time
+    return (noon - 4 * hour_angle) % 1440
+
+
+def build_table(lat, lon):
+    table = []
+    day = datetime.date(TABLE_YEAR, 1, 1)
+    while day.year == TABLE_YEAR:
+        minutes = sunrise_utc_minutes(day, lat, lon)
+        table.append(NO_SUNRISE if minutes is None else int(round(minutes)) % 1440)
+        day += datetime.timedelta(days=1)
+    return table
+
+
+def table_index(date):
+    return (date.replace(year=TABLE_YEAR) - datetime.date(TABLE_YEAR, 1, 1)).days
+
+
+def check(table, lat, lon, utc_offset):
+    """Compare the table with PUBLISHED, True if every date is within CHECK_TOLERANCE."""
+    for (ref_lat, ref_lon), sunrises in PUBLISHED.items():
+        if abs(lat - ref_lat) <= 0.1 and abs(lon - ref_lon) <= 0.1:
+            break
+    else:
+        print("no published sunrise times for %g, %g" % (lat, lon))
+        return False
+
+    ok = True
+    for date, published in sunrises:
+        day = datetime.date(*map(int, date.split("-")))
+        hour, minute = map(int, published.split(":"))
+        entry = table[table_index(day)]
+        local = (entry + int(round(utc_offset * 60))) % 1440
+        error = abs((local - hour * 60 - minute + 720) % 1440 - 720)
+        within = entry != NO_SUNRISE and error <= CHECK_TOLERANCE
+        ok = ok and within
+        print("%s published %s, table %02d:%02d, %s" % (date, published, local // 60, local % 60,
+                                                       "ok" if within else "OFF"))
+    print("within %d minutes" % CHECK_TOLERANCE if ok else "table disagrees with the published times")
+    return ok
+
+
+def write_header(table, args, out):
+    out.write("/* Solar sunrise table\n")
+    out.write("    Generated by tools/solar_table.py --lat %g --lon %g --utc-offset %g\n"
+              % (args.lat, args.lon, args.utc_offset))
+    out.write("    Sunrise in minutes after UTC midnight for each day of a leap year\n")
+    out.write("    (Jan 1 = 0, Feb 29 = 59), SOLAR_NO_SUNRISE where the sun does not rise.\n")
+    out.write("*/\n")
+    out.write("#define SOLAR_LATITUDE %g\n" % args.lat)
+    out.write("#define SOLAR_LONGITUDE %g\n" % args.lon)
+    out.write("#define SOLAR_UTC_OFFSET %d // Local standard time (minutes)\n"
+              % int(round(args.utc_offset * 60)))
+    out.write("#define SOLAR_NO_SUNRISE 0x%X\n\n" % NO_SUNRISE)
+    out.write("const uint16_t solar_sunrise[366] PROGMEM = {\n")
+    for i in range(0, len(table), 12):
+        out.write("    " + ", ".join("%d" % v for v in table[i:i + 12]) + ",\n")
+    out.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--lat", type=float, required=True, help="degrees north")
+    parser.add_argument("--lon", type=float, required=True, help="degrees east")
+    parser.add_argument("--utc-offset", type=float, required=True,
+                        help="local standard time offset from UTC in hours")
+    parser.add_argument("--check", action="store_true", help="compare with published sunrise times")
+    args = parser.parse_args()
+
+    table = build_table(args.lat, args.lon)
+    if args.check:
+        sys.exit(0 if check(table, args.lat, args.lon, args.utc_offset) else 1)
+    else:
+        write_header(table, args, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Show the sunrise clock's telemetry stream: the LED strip and brightness over time.
+
+Point the viewer at the port, which it opens at --baud and sends 'T' to start
+the stream, or at a capture of the stream (a file, or '-' for stdin):
+
+    tools/telemetry_viewer.py /dev/ttyUSB0
+    tools/telemetry_viewer.py capture.bin --text
+
+Reading a port needs pyserial, the plot needs matplotlib; --text prints one
+line per frame instead of plotting.  The frame layout is described in
+telemetry.h.
+"""
+import argparse
+import os
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+HEADER = struct.Struct("<BBIHH")  # brightness, flags, millis, timeline_us, peak_ma
+
+FLAGS = ((0x01, "setup"), (0x02, "sleep"), (0x04, "sunrise"), (0x08, "idle"))
+
+
+def open_source(name, baud):
+    """stdin for '-', a capture for a regular file, anything else is a serial port."""
+    if name == "-":
+        return sys.stdin.buffer
+    if os.path.isfile(name):
+        return open(name, "rb")
+    import serial  # pyserial, only needed for live ports
+
+    port = serial.Serial(name, baud, timeout=1)
+    port.write(b"T")
+    return port
+
+
+def frames(source):
+    """Yield (millis, brightness, flags, timeline_us, peak_ma, [(r, g, b), ...]) for every valid frame."""
+    buffer = b""
+    while True:
+        chunk = source.read(512)
+        if not chunk:
+            return
+        buffer += chunk
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                buffer = buffer[-1:]
+                break
+            if len(buffer) < start + 4:
+                buffer = buffer[start:]
+                break
+            (length,) = struct.unpack_from("<H", buffer, start + 2)
+            end = start + 4 + length + 1
+            if len(buffer) < end:
+                buffer = buffer[start:]
+                break
+            body = buffer[start + 4:end - 1]
+            if (sum(body) & 0xFF) != buffer[end - 1]:
+                # Not a frame (or serial text mixed in), resync after this sync
+                buffer = buffer[start + 1:]
+                continue
+            buffer = buffer[end:]
+            brightness, flags, millis, timeline_us, peak_ma = HEADER.unpack_from(body)
+            data = body[HEADER.size:]
+            leds = [tuple(data[i:i + 3]) for i in range(0, len(data) - 2, 3)]
+            yield millis, brightness, flags, timeline_us, peak_ma, leds
+
+
+def flag_names(flags):
+    return ",".join(name for bit, name in FLAGS if flags & bit) or "clock"
+
+
+def show_text(stream):
+    for millis, brightness, flags, timeline_us, peak_ma, leds in stream:
+        lit = sum(1 for led in leds if any(led))
+        print("%10.3fs brightness %3d %-12s %d/%d lit, first %s, timelines %dus, peak %dmA"
+              % (millis / 1000.0, brightness, flag_names(flags), lit, len(leds),
+                 leds[0] if leds else "-", timeline_us, peak_ma))
+
+
+def show_plot(stream, history):
+    import matplotlib.pyplot as plt
+
+    plt.ion()
+    figure, (strip_axes, level_axes) = plt.subplots(2, 1, figsize=(10, 4),
+                                                    gridspec_kw={"height_ratios": [1, 3]})
+    strip_axes.set_yticks([])
+    level_axes.set_xlabel("seconds")
+    level_axes.set_ylabel("brightness")
+    level_axes.set_ylim(0, 260)
+    line, = level_axes.plot([], [])
+    image = None
+    times, levels = [], []
+
+    for millis, brightness, flags, timeline_us, peak_ma, leds in stream:
+        # Show the strip as it looks: colors scaled by the global brightness
+        row = [[tuple(c * brightness / 255.0 / 255.0 for c in led) for led in leds]]
+        if image is None:
+            image = strip_axes.imshow(row, aspect="auto", interpolation="nearest")
+        else:
+            image.set_data(row)
+        strip_axes.set_title("%s  brightness %d  timelines %dus  peak %dmA"
+                             % (flag_names(flags), brightness, timeline_us, peak_ma))
+
+        times.append(millis / 1000.0)
+        levels.append(brightness)
+        del times[:-history], levels[:-history]
+        line.set_data(times, levels)
+        level_axes.set_xlim(times[0], max(times[-1], times[0] + 1))
+
+        figure.canvas.draw_idle()
+        plt.pause(0.001)
+        if not plt.fignum_exists(figure.number):
+            return
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="serial port, capture file or - for stdin")
+    parser.add_argument("--baud", type=int, default=500000)
+    parser.add_argument("--text", action="store_true", help="print frames instead of plotting")
+    parser.add_argument("--history", type=int, default=600, help="frames kept in the plot")
+    args = parser.parse_args()
+
+    stream = frames(open_source(args.source, args.baud))
+    if args.text:
+        show_text(stream)
+    else:
+        show_plot(stream, args.history)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,222 @@
+/* Daylight saving time
+    With TZ_DST enabled the RTC keeps local standard time all year and the
+    wall-clock time (now_now) is derived from it, so the clock never has to be
+    moved by hand.  The next transition is worked out once and stored as a
+    packed YYMMDDHH key; every loop only compares the RTC's key against it.
+
+    Alarms stay in wall-clock terms.  On the morning of a transition the
+    cached alarm windows are shifted so a sunrise inside the skipped hour
+    starts as soon as the clock jumps forward, and one inside the repeated
+    hour carries on instead of restarting when the clock falls back.
+*/
+#define TZ_DST 1         // Follow the rules below (0 = RTC keeps wall-clock time)
+#define TZ_DST_SHIFT 3600 // Seconds added to standard time while DST is active
+
+struct TzRule
+{
+    byte month; // 1 - 12
+    byte week;  // 1 - 4, 5 = last
+    byte dow;   // 0 = Sunday
+    byte hour;  // Local standard time
+};
+
+// US rules:  second Sunday in March 2:00 to first Sunday in November 2:00 DST (1:00 standard)
+const TzRule tz_dst_start = {3, 2, 0, 2};
+const TzRule tz_dst_end = {11, 1, 0, 1};
+
+DateTime now_std;             // RTC time (local standard time) read this loop
+bool tz_dst = false;          // DST active
+uint32_t tz_next_key = 0;     // tzKey() of the next transition
+
+// Hour-granular key that orders like the date, built without calendar math
+uint32_t tzKey(const DateTime &dtm)
+{
+    return ((uint32_t)(dtm.year() - 2000) << 24) | ((uint32_t)dtm.month() << 16) | ((uint16_t)dtm.day() << 8) | dtm.hour();
+}
+
+byte tzDaysInMonth(uint16_t year, byte month)
+{
+    if (month == 2)
+    {
+        return ((year % 4) == 0) ? 29 : 28;
+    }
+
+    return ((month == 4) || (month == 6) || (month == 9) || (month == 11)) ? 30 : 31;
+}
+
+// Unixtime (standard time) at which the rule fires in the given year
+uint32_t tzTransition(const TzRule &rule, uint16_t year)
+{
+    DateTime first = DateTime(year, rule.month, 1, rule.hour, 0, 0);
+    byte day = 1 + (rule.dow + 7 - first.dayOfTheWeek()) % 7 + (rule.week - 1) * 7;
+
+    while (day > tzDaysInMonth(year, rule.month))
+    {
+        day -= 7;
+    }
+
+    return first.unixtime() + (day - 1) * 86400L;
+}
+
+// Is DST active at the standard time, optionally returning the next transition
+bool tzIsDst(uint32_t std_time, uint32_t *next)
+{
+    uint16_t year = DateTime(std_time).year();
+    uint32_t start = tzTransition(tz_dst_start, year);
+    uint32_t end = tzTransition(tz_dst_end, year);
+    bool dst;
+
+    if (start < end)
+    {
+        // Northern hemisphere, DST in the middle of the year
+        dst = (std_time >= start) && (std_time < end);
+        *next = (std_time < start) ? start : ((std_time < end) ? end : tzTransition(tz_dst_start, year + 1));
+    }
+    else
+    {
+        // Southern hemisphere, DST spans the new year
+        dst = (std_time < end) || (std_time >= start);
+        *next = (std_time < end) ? end : ((std_time < start) ? start : tzTransition(tz_dst_end, year + 1));
+    }
+
+    return dst;
+}
+
+// Minutes DST adds on the date at the standard time of day, 0 or 60
+int tzDstMinutes(const DateTime &date, int minute_of_day)
+{
+#if TZ_DST
+    uint32_t next;
+    uint32_t std_time = DateTime(date.year(), date.month(), date.day()).unixtime() + minute_of_day * 60L;
+    return tzIsDst(std_time, &next) ? TZ_DST_SHIFT / 60 : 0;
+#else
+    return 0;
+#endif
+}
+
+// Recompute the DST state and the next transition from now_std
+void tzSync()
+{
+#if TZ_DST
+    uint32_t next;
+    tz_dst = tzIsDst(now_std.unixtime(), &next);
+    tz_next_key = tzKey(DateTime(next));
+#else
+    tz_next_key = 0xFFFFFFFF;
+#endif
+}
+
+// Wall-clock time for a standard time
+DateTime wallTime(const DateTime &std_time)
+{
+    if (!tz_dst)
+    {
+        return std_time;
+    }
+
+    // Moving the hour along needs no calendar math unless it crosses midnight
+    if (std_time.hour() < 23)
+    {
+        return DateTime(std_time.year(), std_time.month(), std_time.day(), std_time.hour() + 1, std_time.minute(), std_time.second());
+    }
+
+    return DateTime(std_time.unixtime() + TZ_DST_SHIFT);
+}
+
+// Read the RTC and return the wall-clock time
+DateTime localNow()
+{
+    now_std = rtc.now();
+    return wallTime(now_std);
+}
+
+// Set the RTC from a wall-clock time
+//   A time in the repeated hour is taken as its first (DST) pass, a time in the
+//   skipped hour does not exist and lands an hour later on the wall
+void adjustClock(const DateTime &wall)
+{
+    uint32_t std_time = wall.unixtime();
+
+#if TZ_DST
+    uint32_t next;
+    if (tzIsDst(std_time - TZ_DST_SHIFT, &next))
+    {
+        std_time -= TZ_DST_SHIFT;
+    }
+#endif
+
+    rtc.adjust(DateTime(std_time));
+    now_std = rtc.now();
+    tzSync();
+}
+
+// Shift cached alarm windows around the transition that just happened
+//   now_mow is already the first wall minute after the jump
+void tzShiftAlarms()
+{
+    // Wall minute the clock jumped away from
+    int from = tz_dst ? (int)now_mow - 60 : (int)now_mow + 60;
+
+    for (byte i = 0; i < 7; i++)
+    {
+        // Minutes from the jump to the alarm start
+        int after = (int)alarm_mow[i] - from;
+        if (after < 0)
+        {
+            after += MINUTES_PER_WEEK;
+        }
+        else if (after >= MINUTES_PER_WEEK)
+        {
+            after -= MINUTES_PER_WEEK;
+        }
+        int before = (after == 0) ? 0 : MINUTES_PER_WEEK - after;
+
+        int start = alarm_mow[i];
+        if (tz_dst && (after < 60))
+        {
+            // Starts inside the skipped hour, start as soon as the clock jumps
+            start = now_mow;
+        }
+        else if ((before > 0) && (before <= alarm_time + (tz_dst ? 0 : 60)))
+        {
+            // Already running (or, falling back, would run again), keep the
+            // elapsed time following the real time
+            start += tz_dst ? 60 : -60;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (start < 0)
+        {
+            start += MINUTES_PER_WEEK;
+        }
+        else if (start >= MINUTES_PER_WEEK)
+        {
+            start -= MINUTES_PER_WEEK;
+        }
+        alarm_mow[i] = start;
+    }
+}
+
+void syncMinuteOfWeek(); // Minute of the week functions (arduino_sunrise.h)
+void clearLcd();         // Display functions (arduino_sunrise.h)
+
+// Follow a DST transition once the RTC reaches it, a single compare otherwise
+void checkDst()
+{
+    if (tzKey(now_std) < tz_next_key)
+    {
+        return;
+    }
+
+    tzSync();
+    now_now = wallTime(now_std);
+    syncMinuteOfWeek();
+    tzShiftAlarms();
+    logEvent(EVT_DST, tz_dst);
+
+    // The hour jumped, blanking only the previous hour would leave a stale digit
+    clearLcd();
+}